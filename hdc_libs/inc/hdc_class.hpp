@@ -3,6 +3,8 @@
 
 #include "hv_struct.hpp"
 #include "hdc_defines.hpp"
+#include "hdc_item_memory.hpp"
+#include "hdc_quantizer.hpp"
 extern "C" {            // Klessydra dsp_libraries are written in C and so they're imported as extern:
     #include "dsp_functions.h"
     #include "functions.h"
@@ -12,6 +14,187 @@ extern "C" {            // Klessydra dsp_libraries are written in C and so they'
 void generate_quantization_levels(float min, float max, int levels, float LevelList[HD_LV_LEN]);
 int get_quantized_level(float value, float quantization_levels[HD_LV_LEN], int levels);
 
+// --------------------------- Incremental Encoder State: ---------------------
+struct EncoderState {
+    int quantized_features[DS_FEATURE_SIZE]; // Quantized levels of the last encoded sample
+    BundledHV Encoded_HV;                    // Bundled counters of the last encoded sample
+    HV Clipped_HV;                           // Clipped HV of the last encoded sample
+    int valid;                               // 0 until the first sample has been fully encoded
+
+    // Default constructor: the first call to incremental_encoding performs a full encoding
+    EncoderState();
+};
+
+// --------------------------- Bound Item Memory: ----------------------------
+// Precomputed bind(LevelVectors[l], BaseVectors[i]) for all the F x L feature/level pairs.
+// The table is allocated only if it fits in BOUND_TABLE_BUDGET bytes, otherwise the
+// table encoding falls back to binding on the fly.
+#if BOUND_TABLE_SIZE <= BOUND_TABLE_BUDGET
+    #define BOUND_TABLE_EN 1
+#else
+    #define BOUND_TABLE_EN 0
+#endif
+
+struct BoundTable {
+    #if BOUND_TABLE_EN==1
+    HV bound[DS_FEATURE_SIZE * HD_LV_LEN]; // Feature i, level l stored at i * HD_LV_LEN + l
+    #endif
+    int valid;                             // 1 once generate_BoundTable has filled the table
+
+    // Default constructor: empty table
+    BoundTable();
+};
+
+// --------------------------- N-gram State: ----------------------------------
+// Rolling N-gram rho^(N-1)(x_{t-N+1}) ^ ... ^ rho(x_{t-1}) ^ x_t over a stream of HVs
+struct NGramState {
+    HV ngram;                 // Running product of the last N_GRAM_SIZE inputs
+    HV window[N_GRAM_SIZE];   // Last N_GRAM_SIZE inputs (ring buffer)
+    int head;                 // Oldest input of the window, overwritten by the next one
+    int count;                // Inputs in the window: the N-gram is complete when count == N_GRAM_SIZE
+
+    // Default constructor: empty window
+    NGramState();
+};
+
+// --------------------------- Text Encoder State: ----------------------------
+// Rolling character N-gram and bit counters of all the N-grams of a document, so that the
+// document can be streamed in pieces of any length. A state is updated by one backend only:
+// the software encoding keeps the window in ngram, the accelerated one keeps it in the SPM.
+struct TextState {
+    NGramState ngram;                // Rolling N-gram of the symbol HVs
+    int symbols[N_GRAM_SIZE];        // Symbols of the window, used by the accelerated encoding
+    int counters[HV_SIZE_BIT];       // Number of N-grams with bit i set (bit b of chunk c at c * 32 + b)
+    int ngrams;                      // Number of N-grams bundled in the counters
+
+    // Default constructor: empty document
+    TextState();
+};
+
+// Symbol of a character in the text item memory
+int text_symbol(char c);
+
+// --------------------------- Image Keys: -----------------------------------
+// Position keys of the image encoding: pixel (r, c) uses rho^r(row_seed) ^ rho^c(column_seed).
+// Only the IMAGE_WIDTH column keys are cached, the row keys are permuted row by row.
+struct ImageKeys {
+    HV row_seed;
+    HV column[IMAGE_WIDTH];  // rho^c(column_seed)
+};
+
+// --------------------------- Graph State: -----------------------------------
+// Bit counters of the edge HVs of a graph. The edges can be streamed in pieces, and partitions
+// encoded separately (e.g. by different harts) are combined with graph_merge.
+struct GraphState {
+    int counters[HV_SIZE_BIT];       // Number of edges with bit i set (bit b of chunk c at c * 32 + b)
+    int edges;                       // Number of edges bundled in the counters
+
+    // Default constructor: empty graph
+    GraphState();
+};
+
+// --------------------------- Class Accumulator: -----------------------------
+// Non-binarized class vector: bit-sliced counts c_d of the training samples with bit d set.
+// In bipolar terms the class is s_d = samples - 2 * c_d, whose inverse norm is kept up to date
+// from the running sums of c_d and c_d^2 as the samples are added. The counters hold at most
+// 2^SLICED_PLANES - 1 samples: train() rejects the samples beyond that, which would wrap them.
+struct ClassAccumulator {
+    SlicedHV counters;      // c_d
+    int samples;            // Training samples added
+    int64_t sum;            // sum of c_d
+    int64_t squares;        // sum of c_d^2
+    float inv_norm;         // 1 / ||s||, 0 while ||s|| = 0
+
+    // Default constructor: empty class
+    ClassAccumulator();
+};
+
+// --------------------------- Mixed-Precision Class: ------------------------
+// Class prototype with 'bits' bits per dimension, stored as bit planes: u_d in [0, 2^bits - 1]
+// encodes the bipolar weight w_d = 2 u_d - (2^bits - 1), so bits = 1 is the binarized class and
+// higher precisions keep more of the mean of the training samples.
+struct MixedPrecisionClass {
+    int plane[MIXED_MAX_BITS][HV_CHUNKS];   // plane[p]: bit p of u_d
+    int plane_ones[MIXED_MAX_BITS];         // Ones of each plane, for the score and its bounds
+    int bits;
+
+    // Default constructor: empty 1-bit prototype
+    MixedPrecisionClass();
+};
+
+// --------------------------- Compact Model: --------------------------------
+// Model reduced to the 'dimensions' most discriminative dimensions of a trained model. The kept
+// dimensions are packed in the first dimensions / 32 chunks of the HVs, in increasing order, and
+// gather[k] is the dimension of the full model stored at bit k.
+struct CompactModel {
+    int dimensions;                     // Kept dimensions: multiple of 32 in [32, HV_SIZE_BIT], 0 if empty
+    uint16_t gather[HV_SIZE_BIT];
+    HV BaseVectors[DS_FEATURE_SIZE];
+    HV LevelVectors[HD_LV_LEN];
+    HV ClassVectors[HD_CV_LEN];         // Clipped classes of the full model, gathered
+
+    // Default constructor: empty model
+    CompactModel();
+};
+
+// --------------------------- Hierarchical Memory: --------------------------
+// Two-level associative memory over an array of class HVs: the classes are clustered in groups, each
+// summarized by the clipped bundle of its classes (super-vector). member[group_start[g] ... group_start[g + 1] - 1]
+// are the indices of the classes of group g.
+struct HierarchicalMemory {
+    int num_classes;
+    int groups;
+    HV super[HIER_MAX_GROUPS];
+    uint16_t member[HIER_MAX_CLASSES];
+    int group_start[HIER_MAX_GROUPS + 1];
+
+    // Default constructor: empty memory
+    HierarchicalMemory();
+};
+
+// --------------------------- Ensemble: -------------------------------------
+// Models run on the same input. Each member has its own class memory and dimensionality (a prefix of
+// 'words' HV words) and refers to one of the item memories of the ensemble: members with the same item
+// memory share the encoding, computed once up to the longest of their prefixes.
+struct Ensemble {
+    int members;
+    int item_memories;
+    HV BaseVectors[ENSEMBLE_MAX_MEMORIES][DS_FEATURE_SIZE];
+    HV LevelVectors[ENSEMBLE_MAX_MEMORIES][HD_LV_LEN];
+    int item_memory[ENSEMBLE_MAX_MEMBERS];      // Item memory of each member
+    int words[ENSEMBLE_MAX_MEMBERS];            // HV words of each member: dimensionality / 32
+    HV ClassVectors[ENSEMBLE_MAX_MEMBERS][HD_CV_LEN];
+
+    // Default constructor: empty ensemble
+    Ensemble();
+
+    // Add an item memory, returns its index or -1 if the ensemble already has ENSEMBLE_MAX_MEMORIES
+    int add_item_memory(const HV BaseVectors[DS_FEATURE_SIZE], const HV LevelVectors[HD_LV_LEN]);
+
+    // Add a model of 'dimensions' dimensions (multiple of 32 in [32, HV_SIZE_BIT]) using item memory 'item_memory',
+    // returns its index or -1 if the ensemble is full or the item memory or the dimensions are out of range
+    int add_member(int item_memory, int dimensions, const HV ClassVectors[HD_CV_LEN]);
+};
+
+// --------------------------- Regression Model: -----------------------------
+// Continuous target predicted from an encoded HV x (bipolar 1 - 2 x_d) as dot(M_k, x) / HV_SIZE_BIT, where
+// M_k is the real valued model HV of the cluster k nearest to x. The clusters are binary HVs, refreshed after
+// each training epoch with the majority of the samples assigned to them; one cluster is a single linear model.
+struct RegressionModel {
+    int clusters;
+    float learning_rate;
+    float weight[REG_MAX_CLUSTERS][HV_SIZE_BIT];    // Model HVs M_k
+    float weight_sum[REG_MAX_CLUSTERS];             // Sums of the elements of the model HVs
+    HV center[REG_MAX_CLUSTERS];                    // Cluster HVs
+    SlicedHV members[REG_MAX_CLUSTERS];             // Samples assigned to each cluster in the current epoch, halved when full
+
+    // Constructor: zero model HVs, 'clusters' clamped to [1, REG_MAX_CLUSTERS]
+    RegressionModel(int clusters, float learning_rate);
+
+    // Zero model HVs and empty clusters, in place (the model is too large for a temporary on the stack)
+    void reset(int clusters, float learning_rate);
+};
+
 // --------------------------- HDC Class: ------------------------------------- 
 class HDC_op {
 public:
@@ -20,16 +203,20 @@ public:
     int num_levels;        // Number of levels used in the model
     int num_features;      // Number of features used in the model
     int lv_technique;      // Level vector technique: 0: linear, 1: approximately linear, 2: thermometer encoding
-    int density;           // Density of the HV (dense or sparse)
-    float sparsity_factor; // Sparsity factor of the HV (used only for sparse HVs)
-    int HV_similarity;     // HV similarity: 0: Hamming distance, 1: Cosine similarity
+    int density;           // Density of the HV (dense or sparse): informative, the operations follow the HV type (HV or SparseHV)
+    float sparsity_factor; // Fraction of ones of the sparse HVs, at most SPARSE_MAX_DENSITY / 100 (clamped to SPARSE_MAX_ONES)
+    int HV_similarity;     // HV similarity: 0: Hamming distance, 1: Cosine similarity (ClassAccumulator search)
     int quant_min;
     int quant_max;
-    int base_value;        // Base value of the HV (used only for bipolar HVs)
+    int base_value;        // Magnitude of the elements of the bipolar HVs
+    HVRng rng;             // Generator of the base and level HVs
 
     // Constructor
     HDC_op(int dimensionality, int features, int levels);
 
+    // Seed the generator of the base and level HVs
+    void seed(uint32_t seed);
+
     // Base HVs
     void generate_BaseHVs(HV baseVectors[DS_FEATURE_SIZE]);
 
@@ -45,6 +232,9 @@ public:
     // Permutation
     HV permutation(HV hv, int shift);
 
+    // Positional Key: rho^index(seed)
+    HV positional_key(HV seed, int index);
+
     // Bundling
     BundledHV bundle(const BundledHV& HV1, const HV& HV2) const;
 
@@ -57,15 +247,253 @@ public:
     // Encoding
     HV encoding(int FeatureVector[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN]);
 
+    // Procedural Encoding
+    HV encoding(int quantized_features[DS_FEATURE_SIZE], ProceduralItemMemory& item_memory);
+
+    // Encoding of uint8 levels, as written by the quantizers
+    HV encoding(const uint8_t quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN]);
+
+    // Incremental Encoding
+    HV incremental_encoding(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], EncoderState& state);
+
+    // Bound Table Generation
+    void generate_BoundTable(HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], BoundTable& table);
+
+    // Bound Table SPM Load
+    void load_BoundTable(const BoundTable& table, int table_start_addr);
+
+    // Table Encoding
+    HV table_encoding(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], const BoundTable& table);
+
+    // Accl Table Encoding
+    HV accl_table_encoding(int quantized_features[DS_FEATURE_SIZE], int table_start_addr, int bv_start_addr, int lv_start_addr);
+
+    // Positional Encoding
+    HV positional_encoding(int quantized_features[DS_FEATURE_SIZE], HV SeedVector, HV LevelVectors[HD_LV_LEN]);
+
+    // Accl Positional Encoding
+    HV accl_positional_encoding(int quantized_features[DS_FEATURE_SIZE], int seed_addr, int lv_start_addr);
+
+    // Random Projection Encoding
+    HV projection_encoding(const float FeatureVector[DS_FEATURE_SIZE], uint32_t seed);
+
+    // Random Projection Encoding, int8 features
+    HV projection_encoding(const int8_t FeatureVector[DS_FEATURE_SIZE], uint32_t seed);
+
+    // Batched Random Projection Encoding, int8 features
+    void projection_encoding_batch(const int8_t FeatureMatrix[][DS_FEATURE_SIZE], int samples, HV EncodedHVs[], uint32_t seed);
+
     // Accl Encoding
     HV accl_encoding(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr);
 
+    // N-gram Update
+    HV ngram_update(NGramState& state, const HV& input);
+
     // Temporal Encoding
     HV temporal_encoding(int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN]);
     
     // Accl Temporal Encoding
     HV accl_temporal_encoding(int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE], int bv_start_addr, int lv_start_addr);
+
+    // Streaming Temporal Encoding
+    HV temporal_encoding_step(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], NGramState& state);
+
+    // Accl Streaming Temporal Encoding
+    HV accl_temporal_encoding_step(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr, NGramState& state);
     
+    // Text Item Memory
+    void generate_SymbolHVs(HV SymbolVectors[TEXT_ALPHABET]);
+
+    // Store the symbol HVs and their N_GRAM_SIZE permutations in the SPM
+    void load_SymbolHVs(HV SymbolVectors[TEXT_ALPHABET], int symbol_start_addr);
+
+    // Text Encoding: bundle the N-grams of the next length characters of a document
+    void text_encoding(const char* text, int length, HV SymbolVectors[TEXT_ALPHABET], TextState& state);
+
+    // Accl Text Encoding
+    void accl_text_encoding(const char* text, int length, int symbol_start_addr, TextState& state);
+
+    // Document HV: majority of the bundled N-grams
+    HV text_clip(const TextState& state);
+
+    // Clip of bit-sliced counters
+    HV clip(const SlicedHV& sliced_hv, int HV_BUNDLED);
+
+    // Image Keys
+    void generate_ImageKeys(ImageKeys& keys);
+
+    // Image Encoding: pixels are 8-bit intensities, row major
+    HV image_encoding(const uint8_t image[IMAGE_HEIGHT * IMAGE_WIDTH], const ImageKeys& keys, HV LevelVectors[HD_LV_LEN]);
+
+    // Batched Image Encoding
+    void image_encoding_batch(const uint8_t images[][IMAGE_HEIGHT * IMAGE_WIDTH], int count, const ImageKeys& keys, HV LevelVectors[HD_LV_LEN], HV EncodedHVs[]);
+
+    // Edge HV: bind(rho(N_u), N_v), so that u -> v and v -> u differ
+    HV edge_hv(const HV& source, const HV& target);
+
+    // Graph Encoding: bundle the edges[i][0] -> edges[i][1] edges, node HVs from the node memory
+    void graph_encoding(const int edges[][2], int count, NodeMemory& nodes, GraphState& state);
+
+    // Graph Encoding with given node HVs, e.g. after graph_aggregate
+    void graph_encoding(const int edges[][2], int count, const HV NodeHVs[], GraphState& state);
+
+    // Neighbourhood aggregation: each node HV becomes the majority of itself and of its permuted in-neighbours
+    void graph_aggregate(const int edges[][2], int count, int num_nodes, HV NodeHVs[], SlicedHV Accumulators[], int iterations);
+
+    // Merge the counters of a partition of the edges
+    void graph_merge(GraphState& state, const GraphState& partition);
+
+    // Graph HV: majority of the bundled edges
+    HV graph_clip(const GraphState& state);
+
+    // Record Encoding: bundle of the Keys[i] x Values[i] pairs
+    HV record_encoding(const HV Keys[], const HV Values[], int pairs);
+
+    // Cleanup: nearest codebook entry, comparing only the first 'chunks' chunks of the HVs
+    int cleanup(const HV& query, const HV Codebook[], int size, int chunks);
+
+    // Record Query: index in the codebook of the value stored with a key
+    int record_query(const HV& record, const HV& key, const HV Codebook[], int size);
+
+    // Batched Record Query
+    void record_query_batch(const HV& record, const HV Keys[], int queries, const HV Codebook[], int size, int Results[]);
+
+    // Accl Record Query: keys and codebook packed in the SPM (HV_CHUNKS ints per HV)
+    int accl_record_query(int record_addr, int key_addr, int codebook_addr, int size);
+
+    // Resonator Network: factors of a bind of one entry per codebook, returns the iterations or -1 if not converged
+    int resonator(const HV& product, const HV Codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK], int Factors[RESONATOR_FACTORS]);
+
+    // Accl Resonator Network: codebooks packed in the SPM (HV_CHUNKS ints per HV) and in memory for the projection
+    int accl_resonator(int product_addr, int codebook_addr, const HV Codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK], int Factors[RESONATOR_FACTORS]);
+
+    // Sparse HV with sparsity_factor * HV_SIZE random ones, at most SPARSE_MAX_ONES
+    SparseHV sparse_random();
+
+    // Sparse Binding: each segment of 'a' rotated by the positions of 'b' in it and in the next segment
+    SparseHV bind(const SparseHV& a, const SparseHV& b);
+
+    // Sparse Unbinding: inverse rotations, unbind(bind(a, b), b) == a
+    SparseHV unbind(const SparseHV& a, const SparseHV& b);
+
+    // Sparse Bundling: the sparsity_factor * HV_SIZE (at most SPARSE_MAX_ONES) most frequent positions of the inputs
+    SparseHV bundle(const SparseHV inputs[], int count);
+
+    // Sparse Similarity: number of common ones
+    int overlap(const SparseHV& a, const SparseHV& b);
+
+    // Block-Sparse Base HVs
+    void generate_BaseHVs(BlockHV baseVectors[DS_FEATURE_SIZE]);
+
+    // Block-Sparse Level HVs: level l has l * BLOCK_COUNT / (2 * (num_levels - 1)) blocks changed from level 0
+    void generate_LevelVectors(BlockHV LevelVectors[HD_LV_LEN]);
+
+    // Block-Sparse Binding: active positions added modulo BLOCK_LEN
+    BlockHV bind(const BlockHV& a, const BlockHV& b);
+
+    // Block-Sparse Unbinding: active positions subtracted modulo BLOCK_LEN
+    BlockHV unbind(const BlockHV& a, const BlockHV& b);
+
+    // Block-Sparse Bundling: most frequent active position of each block
+    BlockHV bundle(const BlockHV inputs[], int count);
+
+    // Block-Sparse Similarity: number of blocks with the same active position
+    int similarity(const BlockHV& a, const BlockHV& b);
+
+    // Block-Sparse Encoding
+    BlockHV encoding(int quantized_features[DS_FEATURE_SIZE], BlockHV BaseVectors[DS_FEATURE_SIZE], BlockHV LevelVectors[HD_LV_LEN]);
+
+    // Block-Sparse Search: index of the most similar class
+    int Search(const BlockHV& QueryHV, const BlockHV associativeMemory[HD_CV_LEN]);
+
+    // Bipolar HV with random +base_value / -base_value elements
+    BipolarHV bipolar_random();
+
+    // Bipolar Binding: element-wise product, saturated to int8
+    BipolarHV bind(const BipolarHV& a, const BipolarHV& b);
+
+    // Bipolar Bundling: add the HV to the int16 sums, false (and the sums unchanged) if a sum would overflow
+    bool bundle(BundledBipolarHV& bundled_hv, const BipolarHV& hv);
+
+    // Bipolar Clipping: signs of the sums (+base_value for a zero sum)
+    BipolarHV clip(const BundledBipolarHV& bundled_hv);
+
+    // Bipolar Similarity: dot product
+    int dot(const BipolarHV& a, const BipolarHV& b);
+
+    // Dot product of a bundled (unclipped) HV with a bipolar HV
+    int dot(const BundledBipolarHV& a, const BipolarHV& b);
+
+    // Bipolar Search: index of the class with the largest dot product
+    int Search(const BipolarHV& QueryHV, const BundledBipolarHV associativeMemory[HD_CV_LEN]);
+
+    // Accl dot product of two +1/-1 HVs stored in binary form (to_binary) in the SPM
+    int accl_dot(int a_addr, int b_addr);
+
+    // Add a training sample to a class accumulator, refreshing its inverse norm.
+    // Returns false, leaving the class unchanged, once it holds 2^SLICED_PLANES - 1 samples
+    bool train(ClassAccumulator& class_hv, const HV& sample);
+
+    // Bipolar dot product of a binary query with a class accumulator
+    int dot(const ClassAccumulator& class_hv, const HV& QueryHV);
+
+    // Search of the class accumulators: HV_similarity 0: Hamming distance to the clipped classes, 1: cosine similarity
+    int Search(const HV& QueryHV, const ClassAccumulator associativeMemory[HD_CV_LEN]);
+
+    // Quantize a class accumulator to a 'bits' bits prototype (1 <= bits <= MIXED_MAX_BITS)
+    MixedPrecisionClass quantize_class(const ClassAccumulator& class_hv, int bits);
+
+    // Search of mixed-precision prototypes over at most their 'planes' most significant planes, stops as soon
+    // as the remaining planes can't change the best class. 'used_planes' returns the planes evaluated
+    int Search(const HV& QueryHV, const MixedPrecisionClass associativeMemory[HD_CV_LEN], int planes, int& used_planes);
+    int Search(const HV& QueryHV, const MixedPrecisionClass associativeMemory[HD_CV_LEN], int planes);
+
+    // Dimensions sorted by decreasing variance, across the classes, of the mean bipolar class values
+    void rank_dimensions(const ClassAccumulator ClassVectors[HD_CV_LEN], uint16_t ranking[HV_SIZE_BIT]);
+
+    // HV with bit k equal to bit gather[k] of 'hv', for k < dimensions
+    HV gather(const HV& hv, const uint16_t gather[], int dimensions);
+
+    // Compact the trained model (item memories and class accumulators) to its 'dimensions' top ranked dimensions,
+    // false (and an empty model) if 'dimensions' is not a multiple of 32 in [32, HV_SIZE_BIT]
+    bool compact_model(const ClassAccumulator ClassVectors[HD_CV_LEN], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], int dimensions, CompactModel& model);
+
+    // Encoding with the compacted item memories: gather() of the full encoding(), computed on the kept chunks only
+    HV compact_encoding(int quantized_features[DS_FEATURE_SIZE], const CompactModel& model);
+
+    // Search of the compacted classes, on the kept chunks only
+    int Search(const HV& QueryHV, const CompactModel& model);
+
+    // Build a hierarchical memory: k-means (Hamming distance, majority centroids) of the classes in 'groups' groups.
+    // Returns false, leaving the memory empty, unless 1 <= groups <= HIER_MAX_GROUPS and groups <= num_classes <= HIER_MAX_CLASSES
+    bool build_hierarchy(const HV ClassVectors[], int num_classes, int groups, int iterations, HierarchicalMemory& memory);
+
+    // Hierarchical Search: nearest class among the classes of the 'top_groups' groups with the nearest super-vectors.
+    // 'compared' returns the HVs compared with the query
+    int Search(const HV& QueryHV, const HV ClassVectors[], const HierarchicalMemory& memory, int top_groups, int& compared);
+
+    // Ensemble Inference: majority vote of the members, ties to the class with the smallest sum of the member
+    // distances (scaled to HV_SIZE_BIT). 'predictions' returns the class predicted by each member
+    int ensemble_inference(const uint8_t quantized_features[DS_FEATURE_SIZE], const Ensemble& ensemble, int predictions[ENSEMBLE_MAX_MEMBERS]);
+
+    // Batched Ensemble Inference: the samples are quantized once for all the members
+    void ensemble_inference_batch(const float features[][DS_FEATURE_SIZE], int samples, const UniformQuantizer& quantizer, const Ensemble& ensemble, int labels[]);
+
+    // Regression clusters: evenly spaced training samples
+    void regression_init(RegressionModel& model, const HV Samples[], int count);
+
+    // Regression update: M_k += learning_rate * (target - prediction) * x, in the cluster k nearest to x
+    void regression_update(RegressionModel& model, const HV& sample, float target);
+
+    // Regression training: 'epochs' passes of regression_update, the clusters are refreshed after each pass
+    void regression_train(RegressionModel& model, const HV Samples[], const float Targets[], int count, int epochs);
+
+    // Regression prediction
+    float regression_predict(const RegressionModel& model, const HV& sample);
+
+    // Batched regression prediction: the model HVs are scanned once for REG_BATCH samples
+    void regression_predict_batch(const RegressionModel& model, const HV Samples[], int count, float Predictions[]);
+
     // Training
     BundledHV training(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN],  BundledHV ClassVectors[HD_CV_LEN], int class_label);
 
@@ -78,6 +506,11 @@ public:
     // Accl Inference
     int accl_inference(int quantized_features[DS_FEATURE_SIZE],  int bv_start_addr, int lv_start_addr,  HV ClassVectors[HD_CV_LEN]);
 
+    // Progressive Inference: encodes and scores the HV by blocks of words, stopping as soon as the margin between
+    // the two best classes exceeds 'confidence' standard deviations of a random margin, or can't be overturned.
+    // 'words' returns the HV words consumed
+    int progressive_inference(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], HV ClassVectors[HD_CV_LEN], float confidence, int& words);
+
 };
 
 #endif // HDC_OP_HPP
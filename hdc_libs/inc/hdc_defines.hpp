@@ -8,4 +8,41 @@
 	#define COUNTER_BITS 4
 	#define DEBUG 0
 	#define N_GRAM_SIZE 3
+	#define BOUND_TABLE_BUDGET 4096 // Max bytes of the precomputed feature x level bound table (one SPM)
+	#define BOUND_TABLE_SIZE (DS_FEATURE_SIZE * HD_LV_LEN * HV_CHUNKS * 4)
+	#define ITEM_CACHE_SIZE 8       // HVs kept by the LRU cache of the procedural item memory
+	#define PROJECTION_BATCH 4      // Samples sharing each generated column of the random projection
+	#define PROJECTION_BLOCK 4      // HV chunks accumulated at a time by the batched random projection
+	#define TEXT_ALPHABET 27        // Symbols of the text encoder: 'a'-'z' (case folded) and one for everything else
+	#define CORE_CLOCK_MHZ 100      // Core clock used to report throughputs from cycle counts
+	#define SLICED_PLANES 10        // Bit planes of the bit-sliced accumulator: bundles up to 2^10 - 1 HVs
+	#define IMAGE_HEIGHT 28
+	#define IMAGE_WIDTH 28
+	#define IMAGE_BATCH 4           // Images sharing the row keys in the batched image encoding
+	#define NODE_CACHE_SIZE 64      // Entries of the direct-mapped node HV cache of the graph encoder
+	#define QUANT_FRAC_BITS 16      // Fractional bits of the fixed point features of the quantizers
+	#define QUANT_TABLE_SIZE 8      // Thresholds per feature of the quantile quantizer: power of 2, >= HD_LV_LEN
+	#define SKETCH_SUBBUCKETS 8     // Buckets per power of 2 of the quantile sketches (relative error 1/16)
+	#define SKETCH_BINADES 24       // Powers of 2 covered by the quantile sketches, centered on 1
+	#define SPARSE_MAX_DENSITY 5   // Max percentage of ones of the sparse HVs
+	#define SPARSE_MAX_ONES ((HV_SIZE_BIT * SPARSE_MAX_DENSITY + 99) / 100) // Capacity of the index list of the sparse HVs
+	#define SPARSE_SEGMENT_LEN 32   // Positions per segment of the sparse binding: power of 2, divides HV_SIZE
+	#define BLOCK_LEN 32            // Positions per block of the block-sparse HVs: power of 2, at most 128
+	#define BLOCK_COUNT (HV_SIZE_BIT / BLOCK_LEN) // Blocks of the block-sparse HVs: multiple of 4
+	#define RECORD_CODEBOOK_SIZE 16 // Values of the codebook of the record memory
+	#define RECORD_QUERY_BATCH 8    // Queries sharing each codebook pass of the batched record query
+	#define RESONATOR_FACTORS 3     // Factors bound in the products decoded by the resonator network
+	#define RESONATOR_CODEBOOK 8    // Entries of the codebook of each factor
+	#define RESONATOR_MAX_ITER 50   // Iteration cap of the resonator network
+	#define MIXED_MAX_BITS 8        // Max precision of the mixed-precision class prototypes
+	#define PROGRESSIVE_FIRST 2     // HV words encoded and scored before the first confidence check of the progressive inference
+	#define PROGRESSIVE_BLOCK 2     // HV words added at each further step of the progressive inference
+	#define HIER_MAX_CLASSES 1023   // Max classes of the hierarchical associative memory: at most 2^SLICED_PLANES - 1
+	#define HIER_MAX_GROUPS 64      // Max groups (super-vectors) of the hierarchical associative memory
+	#define ENSEMBLE_MAX_MEMBERS 8  // Max models of an ensemble
+	#define ENSEMBLE_MAX_MEMORIES 4 // Max distinct item memories shared by the models of an ensemble
+	#define ENSEMBLE_BATCH 16       // Samples quantized together by the batched ensemble inference
+	#define REG_MAX_CLUSTERS 8      // Max clusters (model HVs) of the regression model
+	#define REG_BATCH 8             // Samples sharing each pass over the model HVs in the batched regression prediction
+	#define GRAPH_BATCH 1023        // Edges bundled in bit-sliced counters before merging: at most 2^SLICED_PLANES - 1
 #endif
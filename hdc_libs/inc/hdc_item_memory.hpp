@@ -0,0 +1,79 @@
+#ifndef HDC_ITEM_MEMORY_HPP
+#define HDC_ITEM_MEMORY_HPP
+
+#include "hv_struct.hpp"
+#include "hdc_defines.hpp"
+
+// --------------------------- Procedural Item Memory: -------------------------
+// Base and level HVs are never stored: each one is regenerated from (model seed, index) with the
+// counter-based hv_hash. Level l is level 0 with the first l * levels_flip positions of a seeded bit
+// permutation flipped, so consecutive levels differ in exactly levels_flip bits.
+// The most recently used HVs are kept in a small LRU cache.
+class ProceduralItemMemory {
+public:
+    uint32_t model_seed;   // Seed of the whole item memory
+    int num_levels;        // Number of levels
+    int levels_flip;       // Bits flipped between two consecutive levels
+    int hits;              // Cache hits
+    int misses;            // Cache misses (HVs regenerated)
+
+    // Constructor
+    ProceduralItemMemory(uint32_t seed, int levels);
+
+    // Base HV of a feature (cached)
+    HV base(int feature);
+
+    // Level HV (cached)
+    HV level(int level);
+
+    // Base HV generation, bypassing the cache
+    void generate_base(int feature, HV& hv) const;
+
+    // Level HV generation, bypassing the cache
+    void generate_level(int level, HV& hv) const;
+
+    // Seeded bijection over the HV bit positions [0, HV_SIZE_BIT)
+    int bit_permutation(int index) const;
+
+    // Write all the base and level HVs, e.g. to load them in the SPMs
+    void materialize(HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN]);
+
+    // Empty the cache
+    void flush();
+
+private:
+    HV cache_hv[ITEM_CACHE_SIZE];
+    int cache_tag[ITEM_CACHE_SIZE];       // -1: empty, feature for base HVs, HV_LEVEL_TAG | level for level HVs
+    uint32_t cache_stamp[ITEM_CACHE_SIZE]; // Last use, the smallest stamp is evicted first
+    uint32_t clock;
+    uint32_t perm_key[3];                  // Round keys of the bit permutation
+    int perm_bits;                         // Bits of the permutation domain, 2^perm_bits >= HV_SIZE_BIT
+
+    HV lookup(int tag);
+};
+
+// --------------------------- Node Item Memory: ------------------------------
+// HVs of the graph nodes, regenerated from (seed, node) like the base HVs of the procedural item memory
+// (node v of a NodeMemory has the HV of feature v of a ProceduralItemMemory with the same seed).
+// Graphs have many nodes and the edges of a node are scattered, so the cache is direct mapped.
+class NodeMemory {
+public:
+    uint32_t model_seed;   // Seed of the node HVs
+    int hits;              // Cache hits
+    int misses;            // Cache misses (HVs regenerated)
+
+    // Constructor
+    NodeMemory(uint32_t seed);
+
+    // HV of a node (cached)
+    HV node(int node);
+
+    // Empty the cache
+    void flush();
+
+private:
+    HV cache_hv[NODE_CACHE_SIZE];
+    int cache_tag[NODE_CACHE_SIZE];   // -1: empty, node otherwise
+};
+
+#endif // HDC_ITEM_MEMORY_HPP
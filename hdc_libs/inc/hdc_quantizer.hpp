@@ -0,0 +1,94 @@
+#ifndef HDC_QUANTIZER_HPP
+#define HDC_QUANTIZER_HPP
+
+#include <stdint.h>
+#include "hdc_defines.hpp"
+
+// --------------------------- Uniform Quantizer: -----------------------------
+// levels bins of equal width over [min, max]: the level of a value is computed directly as
+// (value - min) * levels / (max - min), clamped to [0, levels - 1], instead of scanning the thresholds.
+// Values below min get level 0 and values from max up get the last level. Unlike get_quantized_level,
+// which only returns the last level for values above max, all the levels are used inside the range.
+// Fixed point inputs have QUANT_FRAC_BITS fractional bits and are scaled by a 32-bit reciprocal.
+class UniformQuantizer {
+public:
+    float min;             // Lower bound of the range
+    float max;             // Upper bound of the range
+    int levels;            // Number of levels
+
+    // Constructor
+    UniformQuantizer(float min, float max, int levels);
+
+    // Level of a value
+    int quantize(float value) const;
+
+    // Level of a fixed point value
+    int quantize(int32_t value) const;
+
+    // Levels of a whole feature matrix, one uint8 per feature
+    void quantize_batch(const float features[][DS_FEATURE_SIZE], int samples, uint8_t quantized[][DS_FEATURE_SIZE]) const;
+
+    // Levels of a whole fixed point feature matrix
+    void quantize_batch(const int32_t features[][DS_FEATURE_SIZE], int samples, uint8_t quantized[][DS_FEATURE_SIZE]) const;
+
+private:
+    float scale;           // levels / (max - min)
+    float offset;          // min * scale
+    int32_t fixed_min;     // min in fixed point
+    uint32_t fixed_scale;  // levels / (max - min) in 0.32 fixed point, per fixed point unit
+};
+
+// --------------------------- Quantile Sketch: -------------------------------
+// Streaming histogram of one feature over logarithmic buckets: a value falls in the bucket of its
+// float exponent and of the first bits of its mantissa, so the quantiles have a bounded relative
+// error without computing any logarithm. Magnitudes outside 2^(+-SKETCH_BINADES/2) are clamped to the
+// first or last bucket. Sketches of different parts of a data set are merged by adding their counts.
+#define SKETCH_BUCKETS (SKETCH_SUBBUCKETS * SKETCH_BINADES)
+
+struct QuantileSketch {
+    int positive[SKETCH_BUCKETS];   // Counts of the positive values
+    int negative[SKETCH_BUCKETS];   // Counts of the negative values, by magnitude
+    int zero;                       // Count of the zeros
+    int count;                      // Count of all the values
+
+    // Default constructor: empty sketch
+    QuantileSketch();
+
+    // Add a value
+    void add(float value);
+
+    // Add the counts of another sketch
+    void merge(const QuantileSketch& other);
+
+    // Approximate value of rank q * count, q in [0, 1]
+    float quantile(float q) const;
+};
+
+// --------------------------- Quantile Quantizer: ----------------------------
+// Per-feature thresholds at the quantiles 1/L, ..., (L-1)/L, so that each level receives about the same
+// number of samples even on skewed features. The thresholds of a feature are stored contiguously and
+// padded to QUANT_TABLE_SIZE with FLT_MAX, which makes the lookup a fixed sequence of log2(QUANT_TABLE_SIZE)
+// branch-free binary search steps.
+#if QUANT_TABLE_SIZE < HD_LV_LEN
+    #error "QUANT_TABLE_SIZE must be at least HD_LV_LEN"
+#endif
+
+class QuantileQuantizer {
+public:
+    int levels;                                                  // Number of levels
+    float thresholds[DS_FEATURE_SIZE][QUANT_TABLE_SIZE];         // Lowest value of level l + 1 at [feature][l]
+
+    // Constructor: all the values in level 0 until fit is called
+    QuantileQuantizer(int levels);
+
+    // Thresholds from the sketches of the features
+    void fit(const QuantileSketch sketches[DS_FEATURE_SIZE]);
+
+    // Level of a value of a feature
+    int quantize(int feature, float value) const;
+
+    // Levels of a whole feature matrix, one uint8 per feature
+    void quantize_batch(const float features[][DS_FEATURE_SIZE], int samples, uint8_t quantized[][DS_FEATURE_SIZE]) const;
+};
+
+#endif // HDC_QUANTIZER_HPP
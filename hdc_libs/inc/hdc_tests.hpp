@@ -2,6 +2,8 @@
 #define TESTS_HPP
 #include "hv_struct.hpp"
 #include "hdc_class.hpp"
+#include <float.h>
+#include <math.h>
 
 // --------------------------- Performance counting: --------------------------- 
 // Count functions:
@@ -31,12 +33,78 @@ inline int finish_count(){
  return perf;
 }
 
+// --------------------------- Random Generation Test: ---------------------------
+void test_random_generation()
+{
+    printf("\e[91m--- Test RANDOM GENERATION ---\e[39m\n");
+    HV hv;
+    HVRng rng(42);
+
+    // ---- rand() vs HVRng ----
+    start_count();
+    for (int n = 0; n < 16; n++)
+        for (int i = 0; i < HV_CHUNKS; i++)
+            hv.chunk[i] = rand();
+    int std_cycle = finish_count();
+
+    start_count();
+    for (int n = 0; n < 16; n++)
+        hv.randomize(rng);
+    int rng_cycle = finish_count();
+
+    printf("rand() Execution: %d cycles\n", std_cycle);
+    printf("HVRng Execution: %d cycles\n", rng_cycle);
+    printf("Speed Up Factor: %f\n", (float)std_cycle/rng_cycle);
+
+    bool passed = true;
+
+    // Every bit of the words is random, including bit 31
+    int ones_msb = 0;
+    int words = 64 * HV_CHUNKS;
+    for (int n = 0; n < 64; n++) {
+        hv.randomize(rng);
+        for (int i = 0; i < HV_CHUNKS; i++)
+            ones_msb += ((uint32_t)hv.chunk[i] >> 31) & 1;
+    }
+    printf("Bit 31 set in %d of %d words\n", ones_msb, words);
+    if (ones_msb < words * 2 / 5 || ones_msb > words * 3 / 5)
+        passed = false;
+
+    // Same seed, same model
+    HDC_op hdc_a(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    HDC_op hdc_b(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    hdc_a.seed(7);
+    hdc_b.seed(7);
+    HV base_a[DS_FEATURE_SIZE], base_b[DS_FEATURE_SIZE];
+    hdc_a.generate_BaseHVs(base_a);
+    hdc_b.generate_BaseHVs(base_b);
+    for (int v = 0; v < DS_FEATURE_SIZE; v++)
+        for (int i = 0; i < HV_CHUNKS; i++)
+            if (base_a[v].chunk[i] != base_b[v].chunk[i])
+                passed = false;
+
+    // Jumped generators give different streams
+    HVRng stream_0(7), stream_1(7);
+    stream_1.jump();
+    if (stream_0.next() == stream_1.next())
+        passed = false;
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
 // --------------------------- Binding Test: ---------------------------
 void test_binding() {
+    // Each test has its own seed: the default one is the seed of the HDC_op generators
+    HVRng rng(101);
     HV hv1;
     HV hv2;
-    hv1.randomize();
-    hv2.randomize();
+    hv1.randomize(rng);
+    hv2.randomize(rng);
     HV acc_binded_hv;
     CSR_MVSIZE(HV_CHUNKS * 4);
 
@@ -80,10 +148,11 @@ void test_binding() {
 
 // --------------------------- Permutation Test: ---------------------------
 void test_permutation() {
+    HVRng rng(102);
     HV hv1;
     HV hv2;
-    hv1.randomize();
-    hv2.randomize();
+    hv1.randomize(rng);
+    hv2.randomize(rng);
     HV acc_perm_hv;
     CSR_MVSIZE(HV_CHUNKS * 4);
     int shift_amount = 5; // Example shift amount
@@ -128,14 +197,15 @@ void test_permutation() {
 
 // --------------------------- Bundling Test: ---------------------------
 void test_bundling() {
+    HVRng rng(103);
     printf("\e[91m--- Test BUNDLING ---\e[39m\n");
 
     // ---- Initialization ----
     HV hv1;
     HV hv2;
     BundledHV acc_bundled_hv;
-    hv1.randomize();
-    hv2.randomize();
+    hv1.randomize(rng);
+    hv2.randomize(rng);
 
     // ---- SPM Initialization ----
     void* _spmA = (void*)((int*)spmaddrA);
@@ -182,12 +252,13 @@ void test_bundling() {
 
 // --------------------------- Clipping Test: ---------------------------
 void test_clipping() {
+    HVRng rng(104);
     printf("\e[91m--- Test CLIPPING ---\e[39m\n");
     // ---- Initialization ----
     HV hv1;
     HV hv2;
-    hv1.randomize();
-    hv2.randomize();
+    hv1.randomize(rng);
+    hv2.randomize(rng);
     HV accl_clipped_hv;
     // ---- SPM Initialization ----
     void* _spmA = (void*)((int*)spmaddrA);
@@ -237,11 +308,12 @@ void test_clipping() {
 
 // --------------------------- Similarity Test: ---------------------------
 void test_similarity() {
+    HVRng rng(105);
     printf("\e[91m--- Test SIMILARITY ---\e[39m\n");
     HV hv1;
     HV hv2;
-    hv1.randomize();
-    hv2.randomize();
+    hv1.randomize(rng);
+    hv2.randomize(rng);
     int acc_sim;
     CSR_MVSIZE(HV_CHUNKS * 4);
 
@@ -280,14 +352,15 @@ void test_similarity() {
 
 // --------------------------- Associative Search Test: ---------------------------
 void test_search() {
+    HVRng rng(106);
     printf("\e[91m--- Test ASS. SEARCH ---\e[39m\n");
     
     HV queryHV;
     HV associativeMemory[HD_CV_LEN];
     
-    queryHV.randomize();
+    queryHV.randomize(rng);
     for (int i = 0; i < HD_CV_LEN; i++)
-        associativeMemory[i].randomize();
+        associativeMemory[i].randomize(rng);
     
     int acc_bestIndex;
 
@@ -328,6 +401,48 @@ void test_search() {
 }
 
 
+// --------------------------- Level Vectors Test: ---------------------------
+void test_level_vectors()
+{
+    printf("\e[91m--- Test LEVEL VECTORS ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    HV level_vectors[HD_LV_LEN];
+    bool passed = true;
+    const char* names[3] = {"Linear", "Approx. linear", "Thermometer"};
+
+    for (int technique = 0; technique < 3; technique++) {
+        hdc.lv_technique = technique;
+
+        start_count();
+        hdc.generate_LevelVectors(level_vectors);
+        int cycle = finish_count();
+        printf("%s Execution: %d cycles\n", names[technique], cycle);
+
+        HV zero_HV;
+        int previous = 0;
+        for (int l = 1; l < HD_LV_LEN; l++) {
+            int distance = hdc.similarity(level_vectors[0], level_vectors[l]);
+            int expected = technique == 2 ? l * HV_SIZE_BIT / (HD_LV_LEN - 1) : l * (HV_SIZE_BIT / (2 * HD_LV_LEN));
+            // Linear: exact distance, approximately linear: monotonic and within a slice of the linear distance
+            if (technique == 0 && distance != expected)
+                passed = false;
+            if (technique == 1 && (distance < previous || distance > expected + HV_SIZE_BIT / (4 * HD_LV_LEN)))
+                passed = false;
+            // Thermometer: level l has exactly 'expected' ones
+            if (technique == 2 && (hdc.similarity(level_vectors[l], zero_HV) != expected || distance != expected))
+                passed = false;
+            previous = distance;
+        }
+    }
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
 // --------------------------- Encoding Test: ---------------------------
 void test_encoding()
 {
@@ -419,67 +534,1853 @@ void test_encoding()
 
 }
 
-// --------------------------- Temporal Encoding Test: ---------------------------
-void test_temporal_encoding()
+// --------------------------- Incremental Encoding Test: ---------------------------
+void test_incremental_encoding()
 {
-    // printf("\e[91m--- Test TEMPORAL ENCODING, N_GRAM_SIZE:%d ---\e[39m\n", N_GRAM_SIZE);
-    // // Generate the quantization levels
-    // float quantization_levels[HD_LV_LEN];
-    // generate_quantization_levels(0.0, 1.0, HD_LV_LEN, quantization_levels);
-    // HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
-
-    // // Test the encoding function
-    // float feature_vector[DS_FEATURE_SIZE][N_GRAM_SIZE] = {{0.1, 0.2, 0.3}, {0.2, 0.3, 0.4}, {0.3, 0.4, 0.5}, {0.4, 0.5, 0.6}};
-    // HV base_vectors[DS_FEATURE_SIZE];
-    // HV level_vectors[HD_LV_LEN];
-    // BundledHV zero_HV;
-    // // Generate base and level vectors
-    // hdc.generate_BaseHVs(base_vectors);
-    // hdc.generate_LevelVectors(level_vectors);
-    
-    // // Store the base and level vectors in the SPM and initialize the spmD with zeros
-    // hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
-    // for (int i = 0; i < DS_FEATURE_SIZE; i++)
-    //     hvmemld((void*)((int*)spmaddrA+i*HV_CHUNKS * 4), &base_vectors[i].chunk[0], HV_CHUNKS * 4);
-    // for (int i = 0; i < HD_LV_LEN; i++)
-    //     hvmemld((void*)((int*)spmaddrB+i*HV_CHUNKS * 4), &level_vectors[i].chunk[0], HV_CHUNKS * 4);
+    printf("\e[91m--- Test INCREMENTAL ENCODING ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
 
-    // start_count();
-    // HV encoded_hv = hdc.temporal_encoding(feature_vector, base_vectors, level_vectors, quantization_levels);
-    // int std_cycle = finish_count();
-    // #if DEBUG==1
-    //     printf("Encoded HV -->  ");
-    //     encoded_hv.print();
-    // #endif
+    HV base_vectors[DS_FEATURE_SIZE];
+    HV level_vectors[HD_LV_LEN];
 
-    
-    // // Test the encoding function
-    // start_count();
-    // HV accl_encoded_HV = hdc.accl_temporal_encoding(feature_vector, spmaddrA, spmaddrB, quantization_levels);
-    // int accl_cycle = finish_count();
-    // #if DEBUG==1
-    //     printf("Accl Encoded HV -->  ");
-    //     accl_encoded_HV.print();
-    // #endif
+    // Generate base and level vectors
+    hdc.generate_BaseHVs(base_vectors);
+    hdc.generate_LevelVectors(level_vectors);
 
-    // // ---- SPEED UP Evaluation ----
-    // printf("Standard Execution: %d cycles\n", std_cycle);
-    // printf("Accelerated Execution: %d cycles\n", accl_cycle);
+    // First sample: full encoding stored in the state
+    int quantized_features[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        quantized_features[i] = rand() % HD_LV_LEN;
+    EncoderState state;
+    hdc.incremental_encoding(quantized_features, base_vectors, level_vectors, state);
+
+    bool passed = true;
+    for (int sample = 0; sample < 4; sample++) {
+        // Slowly changing input: a single feature changes between consecutive samples
+        quantized_features[rand() % DS_FEATURE_SIZE] = rand() % HD_LV_LEN;
+
+        start_count();
+        HV incremental_hv = hdc.incremental_encoding(quantized_features, base_vectors, level_vectors, state);
+        int inc_cycle = finish_count();
+        printf("Incremental Execution: %d cycles\n", inc_cycle);
+
+        // The standard encoding prints its own cycle count
+        HV encoded_hv = hdc.encoding(quantized_features, base_vectors, level_vectors);
+
+        for (int i = 0; i < HV_CHUNKS; i++) {
+            if (encoded_hv.chunk[i] != incremental_hv.chunk[i]) {
+                passed = false;
+                break;
+            }
+        }
+    }
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Table Encoding Test: ---------------------------
+void test_table_encoding()
+{
+    printf("\e[91m--- Test TABLE ENCODING, table: %d bytes ---\e[39m\n", BOUND_TABLE_SIZE);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    HV base_vectors[DS_FEATURE_SIZE];
+    HV level_vectors[HD_LV_LEN];
+    BoundTable table;
+    BundledHV zero_HV;
+
+    // Generate base and level vectors and the bound table
+    hdc.generate_BaseHVs(base_vectors);
+    hdc.generate_LevelVectors(level_vectors);
+    hdc.generate_BoundTable(base_vectors, level_vectors, table);
+
+    // Store the bound table (or the base and level vectors) in the SPM and initialize the spmD with zeros
+    hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
+    #if BOUND_TABLE_EN==1
+        hdc.load_BoundTable(table, spmaddrA);
+    #else
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            hvmemld((void*)((int*)spmaddrA+i*HV_CHUNKS * 4), &base_vectors[i].chunk[0], HV_CHUNKS * 4);
+        for (int i = 0; i < HD_LV_LEN; i++)
+            hvmemld((void*)((int*)spmaddrB+i*HV_CHUNKS * 4), &level_vectors[i].chunk[0], HV_CHUNKS * 4);
+    #endif
+
+    int quantized_features[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        quantized_features[i] = rand() % HD_LV_LEN;
+
+    // The standard encoding prints its own cycle count
+    HV encoded_hv = hdc.encoding(quantized_features, base_vectors, level_vectors);
+
+    start_count();
+    HV table_hv = hdc.table_encoding(quantized_features, base_vectors, level_vectors, table);
+    int table_cycle = finish_count();
+
+    start_count();
+    HV accl_table_hv = hdc.accl_table_encoding(quantized_features, spmaddrA, spmaddrA, spmaddrB);
+    int accl_cycle = finish_count();
+
+    printf("Table Execution: %d cycles\n", table_cycle);
+    printf("Accelerated Table Execution: %d cycles\n", accl_cycle);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    bool passed = true;
+    for (int i = 0; i < HV_CHUNKS; i++) {
+        if (encoded_hv.chunk[i] != table_hv.chunk[i] || encoded_hv.chunk[i] != accl_table_hv.chunk[i]) {
+            passed = false;
+            break;
+        }
+    }
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Positional Encoding Test: ---------------------------
+void test_positional_encoding()
+{
+    HVRng rng(107);
+    printf("\e[91m--- Test POSITIONAL ENCODING ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    HV seed_vector;
+    HV level_vectors[HD_LV_LEN];
+    BundledHV zero_HV;
+
+    // A single seed HV replaces the DS_FEATURE_SIZE base vectors
+    seed_vector.randomize(rng);
+    hdc.generate_LevelVectors(level_vectors);
+
+    // Store the seed and level vectors in the SPM and initialize the spmD with zeros
+    hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
+    hvmemld((void*)((int*)spmaddrA), &seed_vector.chunk[0], HV_CHUNKS * 4);
+    for (int i = 0; i < HD_LV_LEN; i++)
+        hvmemld((void*)((int*)spmaddrB+i*HV_CHUNKS * 4), &level_vectors[i].chunk[0], HV_CHUNKS * 4);
+
+    int quantized_features[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        quantized_features[i] = rand() % HD_LV_LEN;
+
+    start_count();
+    HV encoded_hv = hdc.positional_encoding(quantized_features, seed_vector, level_vectors);
+    int std_cycle = finish_count();
+
+    start_count();
+    HV accl_encoded_hv = hdc.accl_positional_encoding(quantized_features, spmaddrA, spmaddrB);
+    int accl_cycle = finish_count();
 
-    // // TEST CHECK
-	// printf("TEST CHECK -->  ");
-    // bool passed = true;
-	// for (int i=0; i< HV_CHUNKS; i++){
-	// 	if (encoded_hv.chunk[i] != accl_encoded_HV.chunk[i]){
-	// 		passed = false;
-	// 		break;
-    // 	}
-	// }
-	// if (passed)
-    //     printf("\e[32mTEST PASSED\e[39m\n\n");
-    // else
-    //     printf("\e[31mTEST FAILED\e[39m\n\n");
+    printf("Standard Execution: %d cycles\n", std_cycle);
+    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+
+    // TEST CHECK: software vs accelerated, and random access keys vs iterated permutations
+    printf("TEST CHECK -->  ");
+    bool passed = true;
+    for (int i = 0; i < HV_CHUNKS; i++) {
+        if (encoded_hv.chunk[i] != accl_encoded_hv.chunk[i]) {
+            passed = false;
+            break;
+        }
+    }
+    HV iterated_key = seed_vector;
+    for (int index = 0; index < 100; index++) {
+        HV key = hdc.positional_key(seed_vector, index);
+        for (int i = 0; i < HV_CHUNKS; i++) {
+            if (key.chunk[i] != iterated_key.chunk[i])
+                passed = false;
+        }
+        iterated_key = hdc.permutation(iterated_key, 1);
+    }
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Procedural Item Memory Test: ---------------------------
+void test_procedural_item_memory()
+{
+    printf("\e[91m--- Test PROCEDURAL ITEM MEMORY, cache: %d HVs ---\e[39m\n", ITEM_CACHE_SIZE);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    ProceduralItemMemory item_memory(1234, HD_LV_LEN);
+    ProceduralItemMemory replica(1234, HD_LV_LEN);
+
+    HV base_vectors[DS_FEATURE_SIZE];
+    HV level_vectors[HD_LV_LEN];
+    item_memory.materialize(base_vectors, level_vectors);
+
+    bool passed = true;
+
+    // Same seed, same HVs, also after the cache evicted them
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+            HV hv = replica.base(i);
+            for (int j = 0; j < HV_CHUNKS; j++)
+                if (hv.chunk[j] != base_vectors[i].chunk[j])
+                    passed = false;
+        }
+        for (int l = 0; l < HD_LV_LEN; l++) {
+            HV hv = replica.level(l);
+            for (int j = 0; j < HV_CHUNKS; j++)
+                if (hv.chunk[j] != level_vectors[l].chunk[j])
+                    passed = false;
+        }
+    }
+
+    // Consecutive levels differ in exactly levels_flip bits, the level distance grows linearly
+    for (int l = 1; l < HD_LV_LEN; l++) {
+        if (hdc.similarity(level_vectors[0], level_vectors[l]) != l * item_memory.levels_flip)
+            passed = false;
+    }
+
+    // Procedural encoding vs encoding with the stored vectors
+    int quantized_features[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        quantized_features[i] = rand() % HD_LV_LEN;
+
+    HV encoded_hv = hdc.encoding(quantized_features, base_vectors, level_vectors);
+
+    start_count();
+    HV procedural_hv = hdc.encoding(quantized_features, item_memory);
+    int procedural_cycle = finish_count();
+    printf("Procedural Execution: %d cycles (cache hits: %d, misses: %d)\n", procedural_cycle, item_memory.hits, item_memory.misses);
+
+    for (int j = 0; j < HV_CHUNKS; j++)
+        if (encoded_hv.chunk[j] != procedural_hv.chunk[j])
+            passed = false;
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Random Projection Encoding Test: ---------------------------
+#define PROJECTION_TRAIN 8      // Training samples per class
+#define PROJECTION_TEST 8       // Test samples per class
+
+// Class HVs by majority of the encoded training samples, then nearest class of every test sample
+int projection_accuracy(HDC_op& hdc, HV train[], HV test[])
+{
+    HV classes[HD_CV_LEN];
+    for (int k = 0; k < HD_CV_LEN; k++) {
+        for (int d = 0; d < HV_SIZE_BIT; d++) {
+            int ones = 0;
+            for (int s = 0; s < PROJECTION_TRAIN; s++)
+                ones += (train[k * PROJECTION_TRAIN + s].chunk[d / 32] >> (d % 32)) & 1;
+            if (2 * ones > PROJECTION_TRAIN)
+                classes[k].chunk[d / 32] |= (1u << (d % 32));
+        }
+    }
+    int correct = 0;
+    for (int k = 0; k < HD_CV_LEN; k++) {
+        for (int s = 0; s < PROJECTION_TEST; s++) {
+            int best = 0, best_distance = HV_SIZE_BIT + 1;
+            for (int c = 0; c < HD_CV_LEN; c++) {
+                int distance = hdc.similarity(test[k * PROJECTION_TEST + s], classes[c]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = c;
+                }
+            }
+            correct += (best == k);
+        }
+    }
+    return correct;
+}
+
+void test_projection_encoding()
+{
+    printf("\e[91m--- Test RANDOM PROJECTION ENCODING ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    const uint32_t seed = 42;
+    const int samples = HD_CV_LEN * (PROJECTION_TRAIN + PROJECTION_TEST);
+
+    HV base_vectors[DS_FEATURE_SIZE];
+    HV level_vectors[HD_LV_LEN];
+    BoundTable table;
+    hdc.generate_BaseHVs(base_vectors);
+    hdc.generate_LevelVectors(level_vectors);
+    hdc.generate_BoundTable(base_vectors, level_vectors, table);
+
+    // Synthetic data: one center per class in [0, 1), samples within +-0.1 of it
+    float centers[HD_CV_LEN][DS_FEATURE_SIZE];
+    for (int k = 0; k < HD_CV_LEN; k++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            centers[k][f] = (rand() % 1000) / 1000.0f;
+
+    static float features[samples][DS_FEATURE_SIZE];
+    static int8_t features_int8[samples][DS_FEATURE_SIZE];
+    static int quantized[samples][DS_FEATURE_SIZE];
+    for (int s = 0; s < samples; s++) {
+        int k = (s < HD_CV_LEN * PROJECTION_TRAIN) ? s / PROJECTION_TRAIN : (s - HD_CV_LEN * PROJECTION_TRAIN) / PROJECTION_TEST;
+        for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+            float x = centers[k][f] + ((rand() % 200) - 100) / 1000.0f;
+            x = x < 0 ? 0 : (x > 0.999f ? 0.999f : x);
+            // Zero centered inputs for the projection, levels for the record based encoding
+            features_int8[s][f] = (int8_t)((x - 0.5f) * 254);
+            features[s][f] = features_int8[s][f];
+            quantized[s][f] = (int)(x * HD_LV_LEN);
+        }
+    }
+
+    static HV record_hv[samples], float_hv[samples], int8_hv[samples], batch_hv[samples];
+
+    // The table encoding computes the same HV as encoding() without printing each call
+    start_count();
+    for (int s = 0; s < samples; s++)
+        record_hv[s] = hdc.table_encoding(quantized[s], base_vectors, level_vectors, table);
+    int record_cycle = finish_count();
+
+    start_count();
+    for (int s = 0; s < samples; s++)
+        float_hv[s] = hdc.projection_encoding(features[s], seed);
+    int float_cycle = finish_count();
+
+    start_count();
+    for (int s = 0; s < samples; s++)
+        int8_hv[s] = hdc.projection_encoding(features_int8[s], seed);
+    int int8_cycle = finish_count();
+
+    start_count();
+    hdc.projection_encoding_batch(features_int8, samples, batch_hv, seed);
+    int batch_cycle = finish_count();
+
+    int record_correct = projection_accuracy(hdc, record_hv, record_hv + HD_CV_LEN * PROJECTION_TRAIN);
+    int projection_correct = projection_accuracy(hdc, int8_hv, int8_hv + HD_CV_LEN * PROJECTION_TRAIN);
+
+    printf("Record Encoding: %d cycles/sample, accuracy %d/%d\n", record_cycle / samples, record_correct, HD_CV_LEN * PROJECTION_TEST);
+    printf("Projection Encoding (float): %d cycles/sample\n", float_cycle / samples);
+    printf("Projection Encoding (int8): %d cycles/sample, accuracy %d/%d\n", int8_cycle / samples, projection_correct, HD_CV_LEN * PROJECTION_TEST);
+    printf("Projection Encoding (int8 batch): %d cycles/sample\n", batch_cycle / samples);
+
+    // TEST CHECK: the float, int8 and batched kernels compute the same signs
+    printf("TEST CHECK -->  ");
+    bool passed = true;
+    for (int s = 0; s < samples; s++) {
+        for (int i = 0; i < HV_CHUNKS; i++) {
+            if (float_hv[s].chunk[i] != int8_hv[s].chunk[i] || int8_hv[s].chunk[i] != batch_hv[s].chunk[i])
+                passed = false;
+        }
+    }
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Text Encoding Test: ---------------------------
+#define TEXT_BENCH_LEN 1024     // Bytes of the throughput benchmark
+
+// Random text over the letters [first, first + letters) with spaces, a crude "language"
+void generate_text(char* text, int length, char first, int letters)
+{
+    for (int n = 0; n < length; n++)
+        text[n] = (rand() % 6 == 0) ? ' ' : (char)(first + rand() % letters);
+}
+
+void test_text_encoding()
+{
+    printf("\e[91m--- Test TEXT ENCODING, N_GRAM_SIZE:%d ---\e[39m\n", N_GRAM_SIZE);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    HV symbol_vectors[TEXT_ALPHABET];
+    hdc.generate_SymbolHVs(symbol_vectors);
+    hdc.load_SymbolHVs(symbol_vectors, spmaddrA);
 
+    static char text[TEXT_BENCH_LEN];
+    generate_text(text, TEXT_BENCH_LEN, 'a', 26);
+
+    // The document is streamed in two pieces to the software encoder and in one to the accelerated one
+    TextState state, accl_state;
+    start_count();
+    hdc.text_encoding(text, TEXT_BENCH_LEN / 3, symbol_vectors, state);
+    hdc.text_encoding(text + TEXT_BENCH_LEN / 3, TEXT_BENCH_LEN - TEXT_BENCH_LEN / 3, symbol_vectors, state);
+    int std_cycle = finish_count();
+
+    start_count();
+    hdc.accl_text_encoding(text, TEXT_BENCH_LEN, spmaddrA, accl_state);
+    int accl_cycle = finish_count();
+
+    HV text_hv = hdc.text_clip(state);
+    HV accl_text_hv = hdc.text_clip(accl_state);
+
+    printf("Standard Execution: %d cycles, %d kB/s at %d MHz\n", std_cycle, std_cycle ? (int)((long long)TEXT_BENCH_LEN * 1000 * CORE_CLOCK_MHZ / std_cycle) : 0, CORE_CLOCK_MHZ);
+    printf("Accelerated Execution: %d cycles, %d kB/s at %d MHz\n", accl_cycle, accl_cycle ? (int)((long long)TEXT_BENCH_LEN * 1000 * CORE_CLOCK_MHZ / accl_cycle) : 0, CORE_CLOCK_MHZ);
+
+    // Language identification: profiles of two languages with different letters, query from the first one
+    static char document[TEXT_BENCH_LEN / 2];
+    TextState first_state, second_state, query_state;
+    generate_text(document, TEXT_BENCH_LEN / 2, 'a', 4);
+    hdc.text_encoding(document, TEXT_BENCH_LEN / 2, symbol_vectors, first_state);
+    generate_text(document, TEXT_BENCH_LEN / 2, 'n', 4);
+    hdc.text_encoding(document, TEXT_BENCH_LEN / 2, symbol_vectors, second_state);
+    generate_text(document, TEXT_BENCH_LEN / 4, 'a', 4);
+    hdc.text_encoding(document, TEXT_BENCH_LEN / 4, symbol_vectors, query_state);
+    HV query_hv = hdc.text_clip(query_state);
+    int first_distance = hdc.similarity(query_hv, hdc.text_clip(first_state));
+    int second_distance = hdc.similarity(query_hv, hdc.text_clip(second_state));
+    printf("Query distance: %d to its language, %d to the other one\n", first_distance, second_distance);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    bool passed = state.ngrams == accl_state.ngrams && first_distance < second_distance;
+    for (int i = 0; i < HV_SIZE_BIT; i++)
+        if (state.counters[i] != accl_state.counters[i])
+            passed = false;
+    for (int i = 0; i < HV_CHUNKS; i++)
+        if (text_hv.chunk[i] != accl_text_hv.chunk[i] || state.ngram.ngram.chunk[i] != accl_state.ngram.ngram.chunk[i])
+            passed = false;
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Image Encoding Test: ---------------------------
+#define IMAGE_BENCH 8           // Images of the throughput benchmark
+
+// Synthetic MNIST-sized digit: a bright rectangle of the class on a dark background, with noise
+void generate_image(uint8_t image[IMAGE_HEIGHT * IMAGE_WIDTH], int label)
+{
+    int top = 4 + 6 * label, left = 20 - 6 * label;
+    for (int r = 0; r < IMAGE_HEIGHT; r++) {
+        for (int c = 0; c < IMAGE_WIDTH; c++) {
+            bool inside = r >= top && r < top + 8 && c >= left && c < left + 8;
+            int noise = rand() % 64;
+            image[r * IMAGE_WIDTH + c] = inside ? 255 - noise : noise;
+        }
+    }
+}
+
+void test_image_encoding()
+{
+    printf("\e[91m--- Test IMAGE ENCODING, %dx%d ---\e[39m\n", IMAGE_HEIGHT, IMAGE_WIDTH);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    ImageKeys keys;
+    HV level_vectors[HD_LV_LEN];
+    hdc.generate_ImageKeys(keys);
+    hdc.generate_LevelVectors(level_vectors);
+
+    static uint8_t images[IMAGE_BENCH][IMAGE_HEIGHT * IMAGE_WIDTH];
+    for (int i = 0; i < IMAGE_BENCH; i++)
+        generate_image(images[i], i % 2);
+
+    HV encoded_hv[IMAGE_BENCH], batch_hv[IMAGE_BENCH];
+    start_count();
+    for (int i = 0; i < IMAGE_BENCH; i++)
+        encoded_hv[i] = hdc.image_encoding(images[i], keys, level_vectors);
+    int std_cycle = finish_count();
+
+    start_count();
+    hdc.image_encoding_batch(images, IMAGE_BENCH, keys, level_vectors, batch_hv);
+    int batch_cycle = finish_count();
+
+    printf("Standard Execution: %d cycles, %d images/s at %d MHz\n", std_cycle, std_cycle ? (int)((long long)IMAGE_BENCH * CORE_CLOCK_MHZ * 1000000 / std_cycle) : 0, CORE_CLOCK_MHZ);
+    printf("Batched Execution: %d cycles, %d images/s at %d MHz\n", batch_cycle, batch_cycle ? (int)((long long)IMAGE_BENCH * CORE_CLOCK_MHZ * 1000000 / batch_cycle) : 0, CORE_CLOCK_MHZ);
+
+    // Reference: every pixel HV built from the position keys and counted in integers
+    static int counters[HV_SIZE_BIT];
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        counters[d] = 0;
+    for (int r = 0; r < IMAGE_HEIGHT; r++) {
+        for (int c = 0; c < IMAGE_WIDTH; c++) {
+            HV position = hdc.bind(hdc.positional_key(keys.row_seed, r), keys.column[c]);
+            HV pixel = hdc.bind(position, level_vectors[(images[0][r * IMAGE_WIDTH + c] * HD_LV_LEN) >> 8]);
+            for (int d = 0; d < HV_SIZE_BIT; d++)
+                counters[d] += (pixel.chunk[d / 32] >> (d % 32)) & 1;
+        }
+    }
+    HV reference_hv;
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        if (counters[d] > IMAGE_HEIGHT * IMAGE_WIDTH / 2)
+            reference_hv.chunk[d / 32] |= (1u << (d % 32));
+
+    int same_distance = hdc.similarity(encoded_hv[0], encoded_hv[2]);
+    int other_distance = hdc.similarity(encoded_hv[0], encoded_hv[1]);
+    printf("Distance: %d to the same class, %d to the other class\n", same_distance, other_distance);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    bool passed = same_distance < other_distance;
+    for (int i = 0; i < HV_CHUNKS; i++) {
+        if (reference_hv.chunk[i] != encoded_hv[0].chunk[i])
+            passed = false;
+        for (int n = 0; n < IMAGE_BENCH; n++)
+            if (encoded_hv[n].chunk[i] != batch_hv[n].chunk[i])
+                passed = false;
+    }
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Graph Encoding Test: ---------------------------
+#define GRAPH_BENCH_EDGES (1 << 20) // Edges of the throughput benchmark, streamed in pieces of GRAPH_BENCH_PIECE
+#define GRAPH_BENCH_PIECE 1024
+#define GRAPH_BENCH_NODES 256
+
+void test_graph_encoding()
+{
+    printf("\e[91m--- Test GRAPH ENCODING, %d edges ---\e[39m\n", GRAPH_BENCH_EDGES);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    NodeMemory nodes(7);
+    bool passed = true;
+
+    // Throughput: random edges, the two halves encoded as separate partitions and merged
+    static int edges[GRAPH_BENCH_PIECE][2];
+    GraphState state, partition[2];
+    long long cycles = 0;
+    for (int piece = 0; piece < GRAPH_BENCH_EDGES / GRAPH_BENCH_PIECE; piece++) {
+        for (int e = 0; e < GRAPH_BENCH_PIECE; e++) {
+            edges[e][0] = rand() % GRAPH_BENCH_NODES;
+            edges[e][1] = rand() % GRAPH_BENCH_NODES;
+        }
+        start_count();
+        hdc.graph_encoding(edges, GRAPH_BENCH_PIECE, nodes, state);
+        cycles += finish_count();
+        hdc.graph_encoding(edges, GRAPH_BENCH_PIECE, nodes, partition[piece % 2]);
+    }
+    hdc.graph_merge(partition[0], partition[1]);
+    printf("Standard Execution: %lld cycles, %d edges/s at %d MHz (node cache hits: %d, misses: %d)\n", cycles, cycles ? (int)((long long)GRAPH_BENCH_EDGES * CORE_CLOCK_MHZ * 1000000 / cycles) : 0, CORE_CLOCK_MHZ, nodes.hits, nodes.misses);
+    for (int i = 0; i < HV_SIZE_BIT; i++)
+        if (state.counters[i] != partition[0].counters[i])
+            passed = false;
+    if (state.edges != GRAPH_BENCH_EDGES || partition[0].edges != GRAPH_BENCH_EDGES)
+        passed = false;
+
+    // Reference counters of the last piece, with the node HVs regenerated one by one
+    GraphState piece_state;
+    static int counters[HV_SIZE_BIT];
+    hdc.graph_encoding(edges, GRAPH_BENCH_PIECE, nodes, piece_state);
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        counters[d] = 0;
+    for (int e = 0; e < GRAPH_BENCH_PIECE; e++) {
+        HV source, target;
+        source.randomize(nodes.model_seed, edges[e][0]);
+        target.randomize(nodes.model_seed, edges[e][1]);
+        HV edge = hdc.bind(hdc.permutation(source, 1), target);
+        for (int d = 0; d < HV_SIZE_BIT; d++)
+            counters[d] += (edge.chunk[d / 32] >> (d % 32)) & 1;
+    }
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        if (counters[d] != piece_state.counters[d])
+            passed = false;
+
+    // Aggregation on the path 0 -> 1 -> 2: H_1 = majority(H_1, rho(H_0)) = H_1 & rho(H_0), H_0 is unchanged
+    const int path[2][2] = {{0, 1}, {1, 2}};
+    HV node_hvs[3];
+    SlicedHV accumulators[3];
+    for (int v = 0; v < 3; v++)
+        node_hvs[v] = nodes.node(v);
+    HV expected = hdc.permutation(node_hvs[0], 1);
+    for (int i = 0; i < HV_CHUNKS; i++)
+        expected.chunk[i] &= node_hvs[1].chunk[i];
+    hdc.graph_aggregate(path, 2, 3, node_hvs, accumulators, 1);
+    HV node_0 = nodes.node(0);
+    for (int i = 0; i < HV_CHUNKS; i++)
+        if (node_hvs[1].chunk[i] != expected.chunk[i] || node_hvs[0].chunk[i] != node_0.chunk[i])
+            passed = false;
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Record Memory Test: ---------------------------
+#define RECORD_PAIRS 7          // Pairs of the record checked against the accelerated query
+#define RECORD_MAX_PAIRS 63     // Largest record of the capacity sweep
+
+void test_record_memory()
+{
+    HVRng rng(108);
+    printf("\e[91m--- Test RECORD MEMORY, codebook: %d values ---\e[39m\n", RECORD_CODEBOOK_SIZE);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    HV codebook[RECORD_CODEBOOK_SIZE];
+    static HV keys[RECORD_MAX_PAIRS], values[RECORD_MAX_PAIRS];
+    int stored[RECORD_MAX_PAIRS];
+    for (int i = 0; i < RECORD_CODEBOOK_SIZE; i++)
+        codebook[i].randomize(rng);
+    for (int i = 0; i < RECORD_MAX_PAIRS; i++) {
+        keys[i].randomize(rng);
+        stored[i] = rand() % RECORD_CODEBOOK_SIZE;
+        values[i] = codebook[stored[i]];
+    }
+
+    HV record = hdc.record_encoding(keys, values, RECORD_PAIRS);
+
+    // Record at the start of spmA, keys packed after it, codebook packed in spmB
+    hvmemld((void*)((int*)spmaddrA), &record.chunk[0], sizeof(record));
+    hvmemld((void*)((int*)spmaddrA + HV_CHUNKS), &keys[0].chunk[0], RECORD_PAIRS * sizeof(HV));
+    hvmemld((void*)((int*)spmaddrB), &codebook[0].chunk[0], sizeof(codebook));
+
+    int std_result[RECORD_PAIRS], batch_result[RECORD_PAIRS], accl_result[RECORD_PAIRS];
+    start_count();
+    for (int i = 0; i < RECORD_PAIRS; i++)
+        std_result[i] = hdc.record_query(record, keys[i], codebook, RECORD_CODEBOOK_SIZE);
+    int std_cycle = finish_count();
+
+    start_count();
+    hdc.record_query_batch(record, keys, RECORD_PAIRS, codebook, RECORD_CODEBOOK_SIZE, batch_result);
+    int batch_cycle = finish_count();
+
+    start_count();
+    for (int i = 0; i < RECORD_PAIRS; i++)
+        accl_result[i] = hdc.accl_record_query(spmaddrA, spmaddrA + (1 + i) * HV_CHUNKS * (int)sizeof(int), spmaddrB, RECORD_CODEBOOK_SIZE);
+    int accl_cycle = finish_count();
+
+    printf("Standard Execution: %d cycles/query\n", std_cycle / RECORD_PAIRS);
+    printf("Batched Execution: %d cycles/query\n", batch_cycle / RECORD_PAIRS);
+    printf("Accelerated Execution: %d cycles/query\n", accl_cycle / RECORD_PAIRS);
+
+    // Capacity: fraction of the values retrieved, on the first D bits of the HVs
+    printf("Retrieved values (pairs: ");
+    for (int pairs = 3; pairs <= RECORD_MAX_PAIRS; pairs = 2 * pairs + 1)
+        printf("%d ", pairs);
+    printf(")\n");
+    for (int chunks = HV_CHUNKS / 4; chunks <= HV_CHUNKS; chunks *= 2) {
+        printf("  D = %4d:", chunks * 32);
+        for (int pairs = 3; pairs <= RECORD_MAX_PAIRS; pairs = 2 * pairs + 1) {
+            HV capacity_record = hdc.record_encoding(keys, values, pairs);
+            int retrieved = 0;
+            for (int i = 0; i < pairs; i++)
+                retrieved += hdc.cleanup(hdc.bind(capacity_record, keys[i]), codebook, RECORD_CODEBOOK_SIZE, chunks) == stored[i];
+            printf(" %3d%%", 100 * retrieved / pairs);
+        }
+        printf("\n");
+    }
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    bool passed = true;
+    for (int i = 0; i < RECORD_PAIRS; i++)
+        if (std_result[i] != stored[i] || batch_result[i] != stored[i] || accl_result[i] != stored[i])
+            passed = false;
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Resonator Network Test: ---------------------------
+void test_resonator()
+{
+    HVRng rng(109);
+    printf("\e[91m--- Test RESONATOR NETWORK, %d factors x %d entries ---\e[39m\n", RESONATOR_FACTORS, RESONATOR_CODEBOOK);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    static HV codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK];
+    int factors[RESONATOR_FACTORS];
+    HV product;
+    for (int f = 0; f < RESONATOR_FACTORS; f++) {
+        for (int i = 0; i < RESONATOR_CODEBOOK; i++)
+            codebooks[f][i].randomize(rng);
+        factors[f] = rand() % RESONATOR_CODEBOOK;
+        product = hdc.bind(product, codebooks[f][factors[f]]);
+    }
+
+    // Product at the start of spmA, codebooks packed in spmB
+    hvmemld((void*)((int*)spmaddrA), &product.chunk[0], sizeof(product));
+    hvmemld((void*)((int*)spmaddrB), &codebooks[0][0].chunk[0], sizeof(codebooks));
+
+    // Brute force over all the combinations, for reference
+    int brute_factors[RESONATOR_FACTORS];
+    int best_distance = HV_SIZE_BIT + 1;
+    int combinations = 1;
+    for (int f = 0; f < RESONATOR_FACTORS; f++)
+        combinations *= RESONATOR_CODEBOOK;
+    start_count();
+    for (int combination = 0; combination < combinations; combination++) {
+        HV candidate;
+        for (int f = 0, c = combination; f < RESONATOR_FACTORS; f++, c /= RESONATOR_CODEBOOK)
+            candidate = hdc.bind(candidate, codebooks[f][c % RESONATOR_CODEBOOK]);
+        int distance = hdc.similarity(candidate, product);
+        if (distance < best_distance) {
+            best_distance = distance;
+            for (int f = 0, c = combination; f < RESONATOR_FACTORS; f++, c /= RESONATOR_CODEBOOK)
+                brute_factors[f] = c % RESONATOR_CODEBOOK;
+        }
+    }
+    int brute_cycle = finish_count();
+
+    int std_factors[RESONATOR_FACTORS], accl_factors[RESONATOR_FACTORS];
+    start_count();
+    int std_iterations = hdc.resonator(product, codebooks, std_factors);
+    int std_cycle = finish_count();
+
+    start_count();
+    int accl_iterations = hdc.accl_resonator(spmaddrA, spmaddrB, codebooks, accl_factors);
+    int accl_cycle = finish_count();
+
+    printf("Brute Force Execution: %d cycles\n", brute_cycle);
+    printf("Standard Execution: %d cycles, %d iterations\n", std_cycle, std_iterations);
+    printf("Accelerated Execution: %d cycles, %d iterations\n", accl_cycle, accl_iterations);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    bool passed = std_iterations > 0 && std_iterations == accl_iterations;
+    for (int f = 0; f < RESONATOR_FACTORS; f++)
+        if (std_factors[f] != factors[f] || accl_factors[f] != factors[f] || brute_factors[f] != factors[f])
+            passed = false;
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Quantization Test: ---------------------------
+#define QUANT_BENCH 256         // Samples of the quantization benchmark
+
+void test_quantization()
+{
+    printf("\e[91m--- Test QUANTIZATION, %d samples ---\e[39m\n", QUANT_BENCH);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    UniformQuantizer quantizer(0.0f, 1.0f, HD_LV_LEN);
+    float quantization_levels[HD_LV_LEN];
+    generate_quantization_levels(0.0f, 1.0f, HD_LV_LEN, quantization_levels);
+
+    // Values slightly beyond the range on both sides
+    static float features[QUANT_BENCH][DS_FEATURE_SIZE];
+    static int32_t fixed_features[QUANT_BENCH][DS_FEATURE_SIZE];
+    for (int s = 0; s < QUANT_BENCH; s++) {
+        for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+            fixed_features[s][f] = (rand() % (5 << QUANT_FRAC_BITS)) / 4 - (1 << QUANT_FRAC_BITS) / 8;
+            features[s][f] = (float)fixed_features[s][f] / (1 << QUANT_FRAC_BITS);
+        }
+    }
+
+    static int scan_levels[QUANT_BENCH][DS_FEATURE_SIZE];
+    static uint8_t float_levels[QUANT_BENCH][DS_FEATURE_SIZE], fixed_levels[QUANT_BENCH][DS_FEATURE_SIZE];
+    start_count();
+    for (int s = 0; s < QUANT_BENCH; s++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            scan_levels[s][f] = get_quantized_level(features[s][f], quantization_levels, HD_LV_LEN);
+    int scan_cycle = finish_count();
+
+    start_count();
+    quantizer.quantize_batch(features, QUANT_BENCH, float_levels);
+    int float_cycle = finish_count();
+
+    start_count();
+    quantizer.quantize_batch(fixed_features, QUANT_BENCH, fixed_levels);
+    int fixed_cycle = finish_count();
+
+    printf("Threshold Scan Execution: %d cycles\n", scan_cycle);
+    printf("Uniform Quantizer Execution: %d cycles\n", float_cycle);
+    printf("Fixed Point Uniform Quantizer Execution: %d cycles\n", fixed_cycle);
+
+    // TEST CHECK: float and fixed point levels match floor((x - min) * L / (max - min)), clamped
+    printf("TEST CHECK -->  ");
+    bool passed = true;
+    for (int s = 0; s < QUANT_BENCH; s++) {
+        for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+            int expected = (int)((double)fixed_features[s][f] * HD_LV_LEN / (1 << QUANT_FRAC_BITS) + HD_LV_LEN) - HD_LV_LEN;
+            expected = expected < 0 ? 0 : (expected > HD_LV_LEN - 1 ? HD_LV_LEN - 1 : expected);
+            if (float_levels[s][f] != expected || fixed_levels[s][f] != expected)
+                passed = false;
+
+            // Threshold scan: the same bins, except that the values of the last bin of the range stay at level
+            // HD_LV_LEN - 2 (only values above max get the last level) and values on a threshold fall in the lower bin
+            int expected_scan = features[s][f] > 1.0f ? HD_LV_LEN - 1 : (expected < HD_LV_LEN - 2 ? expected : HD_LV_LEN - 2);
+            bool on_threshold = scan_levels[s][f] == expected_scan - 1 && quantization_levels[expected_scan] == features[s][f];
+            if (scan_levels[s][f] != expected_scan && !on_threshold)
+                passed = false;
+        }
+    }
+
+    // The uint8 levels encode like the int ones
+    HV base_vectors[DS_FEATURE_SIZE];
+    HV level_vectors[HD_LV_LEN];
+    BoundTable table;
+    hdc.generate_BaseHVs(base_vectors);
+    hdc.generate_LevelVectors(level_vectors);
+    HV uint8_hv = hdc.encoding(float_levels[0], base_vectors, level_vectors);
+    int int_levels[DS_FEATURE_SIZE];
+    for (int f = 0; f < DS_FEATURE_SIZE; f++)
+        int_levels[f] = float_levels[0][f];
+    HV int_hv = hdc.table_encoding(int_levels, base_vectors, level_vectors, table);
+    for (int i = 0; i < HV_CHUNKS; i++)
+        if (uint8_hv.chunk[i] != int_hv.chunk[i])
+            passed = false;
+
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Quantile Quantization Test: ---------------------------
+void test_quantile_quantization()
+{
+    printf("\e[91m--- Test QUANTILE QUANTIZATION, %d samples ---\e[39m\n", QUANT_BENCH);
+
+    // Heavy tailed features: 1 / u, with a sign for the odd features
+    static float features[QUANT_BENCH][DS_FEATURE_SIZE];
+    for (int s = 0; s < QUANT_BENCH; s++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            features[s][f] = (f % 2 ? -1.0f : 1.0f) / ((rand() % 1000 + 1) / 1000.0f);
+
+    // One streaming pass, in two halves merged at the end (e.g. two harts)
+    static QuantileSketch sketches[DS_FEATURE_SIZE], halves[2][DS_FEATURE_SIZE];
+    start_count();
+    for (int s = 0; s < QUANT_BENCH; s++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            halves[s % 2][f].add(features[s][f]);
+    for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+        sketches[f] = halves[0][f];
+        sketches[f].merge(halves[1][f]);
+    }
+    int sketch_cycle = finish_count();
+
+    QuantileQuantizer quantizer(HD_LV_LEN);
+    quantizer.fit(sketches);
+
+    static uint8_t quantized[QUANT_BENCH][DS_FEATURE_SIZE];
+    start_count();
+    quantizer.quantize_batch(features, QUANT_BENCH, quantized);
+    int quantize_cycle = finish_count();
+
+    printf("Sketch Execution: %d cycles\n", sketch_cycle);
+    printf("Quantile Quantizer Execution: %d cycles\n", quantize_cycle);
+
+    // Samples per level of feature 0, with the quantile and with the uniform quantizer over the same range
+    float min = features[0][0], max = features[0][0];
+    for (int s = 0; s < QUANT_BENCH; s++) {
+        min = features[s][0] < min ? features[s][0] : min;
+        max = features[s][0] > max ? features[s][0] : max;
+    }
+    UniformQuantizer uniform(min, max, HD_LV_LEN);
+    int quantile_histogram[HD_LV_LEN] = {0}, uniform_histogram[HD_LV_LEN] = {0};
+    for (int s = 0; s < QUANT_BENCH; s++) {
+        quantile_histogram[quantized[s][0]]++;
+        uniform_histogram[uniform.quantize(features[s][0])]++;
+    }
+    printf("Samples per level (quantile / uniform):");
+    for (int l = 0; l < HD_LV_LEN; l++)
+        printf(" %d/%d", quantile_histogram[l], uniform_histogram[l]);
+    printf("\n");
+
+    // TEST CHECK: levels of the binary search vs a linear scan of the thresholds, balanced levels
+    printf("TEST CHECK -->  ");
+    bool passed = true;
+    for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+        int count = 0;
+        for (int i = 0; i < SKETCH_BUCKETS; i++)
+            count += sketches[f].positive[i] + sketches[f].negative[i];
+        if (count + sketches[f].zero != QUANT_BENCH || sketches[f].count != QUANT_BENCH)
+            passed = false;
+    }
+    for (int s = 0; s < QUANT_BENCH; s++) {
+        for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+            int level = 0;
+            while (level < HD_LV_LEN - 1 && quantizer.thresholds[f][level] <= features[s][f])
+                level++;
+            if (quantized[s][f] != level)
+                passed = false;
+        }
+    }
+    for (int l = 0; l < HD_LV_LEN; l++)
+        if (quantile_histogram[l] < QUANT_BENCH / HD_LV_LEN / 2)
+            passed = false;
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Sparse HV Test: ---------------------------
+void test_sparse_hv()
+{
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    printf("\e[91m--- Test SPARSE HV, sparsity factor: %d%% ---\e[39m\n", (int)(hdc.sparsity_factor * 100));
+
+    SparseHV a = hdc.sparse_random();
+    SparseHV b = hdc.sparse_random();
+    HV dense_a = a.to_dense();
+    HV dense_b = b.to_dense();
+
+    start_count();
+    int dense_distance = hdc.similarity(dense_a, dense_b);
+    int dense_similarity_cycle = finish_count();
+
+    start_count();
+    int common = hdc.overlap(a, b);
+    int sparse_similarity_cycle = finish_count();
+
+    start_count();
+    HV dense_bound = hdc.bind(dense_a, dense_b);
+    int dense_bind_cycle = finish_count();
+    (void)dense_bound;    // Only timed
+
+    start_count();
+    SparseHV bound = hdc.bind(a, b);
+    int sparse_bind_cycle = finish_count();
+
+    // Bundle of a, a and b: all the ones of a are the most frequent positions
+    SparseHV inputs[3] = {a, a, b};
+    start_count();
+    SparseHV bundled = hdc.bundle(inputs, 3);
+    int sparse_bundle_cycle = finish_count();
+
+    printf("Dense Similarity: %d cycles, Sparse Similarity: %d cycles\n", dense_similarity_cycle, sparse_similarity_cycle);
+    printf("Dense Binding: %d cycles, Sparse Binding: %d cycles\n", dense_bind_cycle, sparse_bind_cycle);
+    printf("Sparse Bundling: %d cycles\n", sparse_bundle_cycle);
+    printf("Memory: %d bytes dense HV, %d bytes SparseHV (capacity %d positions, %d used), %d%% saved\n",
+           (int)sizeof(HV), (int)sizeof(SparseHV), SPARSE_MAX_ONES, a.ones, 100 - (int)(100 * sizeof(SparseHV) / sizeof(HV)));
+
+    // A key with one position moved binds close to b, an unrelated key far from it
+    SparseHV near_b = b, c = hdc.sparse_random();
+    int moved = (near_b.index[0] + SPARSE_SEGMENT_LEN * 3 + 5) % HV_SIZE_BIT;
+    bool free_position = true;
+    for (int i = 0; i < b.ones; i++)
+        free_position = free_position && b.index[i] != moved;
+    if (free_position) {
+        HV dense_near = dense_b;
+        dense_near.chunk[b.index[0] / 32] &= ~(int)(1u << (b.index[0] % 32));
+        dense_near.chunk[moved / 32] |= (int)(1u << (moved % 32));
+        near_b.from_dense(dense_near);
+    }
+    int near_overlap = hdc.overlap(bound, hdc.bind(a, near_b));
+    int unrelated_overlap = hdc.overlap(bound, hdc.bind(a, c));
+    printf("Bound HVs overlap: %d/%d with a key differing in one position, %d/%d with an unrelated key\n", near_overlap, a.ones, unrelated_overlap, a.ones);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    HV common_hv;
+    for (int i = 0; i < HV_CHUNKS; i++)
+        common_hv.chunk[i] = dense_a.chunk[i] & dense_b.chunk[i];
+    int dense_common = 0;
+    for (int i = 0; i < HV_CHUNKS; i++)
+        dense_common += __builtin_popcount((uint32_t)common_hv.chunk[i]);
+
+    SparseHV roundtrip, unbound = hdc.unbind(bound, b);
+    roundtrip.from_dense(dense_a);
+    bool passed = common == dense_common && dense_distance == a.ones + b.ones - 2 * common;
+    passed = passed && sizeof(SparseHV) < sizeof(HV);
+    passed = passed && bound.ones == a.ones && unbound.ones == a.ones && roundtrip.ones == a.ones;
+    passed = passed && hdc.overlap(bundled, a) == a.ones && bundled.ones == a.ones;
+    passed = passed && near_overlap >= a.ones / 2 && unrelated_overlap < a.ones / 3;
+    for (int i = 0; i < a.ones; i++)
+        if (roundtrip.index[i] != a.index[i] || unbound.index[i] != a.index[i] || (i > 0 && bound.index[i] <= bound.index[i - 1]))
+            passed = false;
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Block-Sparse HV Test: ---------------------------
+void test_block_hv()
+{
+    printf("\e[91m--- Test BLOCK-SPARSE HV, %d blocks x %d positions ---\e[39m\n", BLOCK_COUNT, BLOCK_LEN);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    BlockHV base_vectors[DS_FEATURE_SIZE];
+    BlockHV level_vectors[HD_LV_LEN];
+    hdc.generate_BaseHVs(base_vectors);
+    hdc.generate_LevelVectors(level_vectors);
+
+    // Word-parallel kernels vs block by block
+    BlockHV a = base_vectors[0], b = base_vectors[1];
+    start_count();
+    BlockHV bound = hdc.bind(a, b);
+    int bind_cycle = finish_count();
+    start_count();
+    int matches = hdc.similarity(a, b);
+    int similarity_cycle = finish_count();
+
+    HV dense_a = a.to_dense(), dense_b = b.to_dense();
+    start_count();
+    hdc.bind(dense_a, dense_b);
+    int dense_bind_cycle = finish_count();
+    start_count();
+    int dense_distance = hdc.similarity(dense_a, dense_b);
+    int dense_similarity_cycle = finish_count();
+
+    int expected_matches = 0;
+    for (int k = 0; k < BLOCK_COUNT; k++) {
+        expected_matches += a.get(k) == b.get(k);
+        if (bound.get(k) != (a.get(k) + b.get(k)) % BLOCK_LEN)
+            passed = false;
+    }
+    BlockHV unbound = hdc.unbind(bound, b);
+    passed = passed && matches == expected_matches && dense_distance == 2 * (BLOCK_COUNT - matches);
+    passed = passed && hdc.similarity(unbound, a) == BLOCK_COUNT;
+
+    // Bundle of a, a and b is a; levels at linearly decreasing similarity
+    BlockHV inputs[3] = {a, a, b};
+    passed = passed && hdc.similarity(hdc.bundle(inputs, 3), a) == BLOCK_COUNT;
+    for (int l = 0; l < HD_LV_LEN; l++)
+        if (hdc.similarity(level_vectors[0], level_vectors[l]) != BLOCK_COUNT - l * BLOCK_COUNT / (2 * (HD_LV_LEN - 1)))
+            passed = false;
+
+    // Encoding and search: the class of a sample is found from the encoding of a sample with one level changed
+    BlockHV class_vectors[HD_CV_LEN];
+    int quantized_features[HD_CV_LEN][DS_FEATURE_SIZE];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            quantized_features[c][i] = (c + i) % HD_LV_LEN;
+        class_vectors[c] = hdc.encoding(quantized_features[c], base_vectors, level_vectors);
+    }
+    quantized_features[2][0] = (quantized_features[2][0] + 1) % HD_LV_LEN;
+    start_count();
+    BlockHV query = hdc.encoding(quantized_features[2], base_vectors, level_vectors);
+    int predicted_class = hdc.Search(query, class_vectors);
+    int inference_cycle = finish_count();
+    passed = passed && predicted_class == 2;
+
+    printf("Dense Binding: %d cycles, Block Binding: %d cycles\n", dense_bind_cycle, bind_cycle);
+    printf("Dense Similarity: %d cycles, Block Similarity: %d cycles\n", dense_similarity_cycle, similarity_cycle);
+    printf("Block Encoding and Search: %d cycles\n", inference_cycle);
+    printf("Item Memory: %d bytes dense, %d bytes block-sparse\n", (DS_FEATURE_SIZE + HD_LV_LEN) * (int)sizeof(HV), (DS_FEATURE_SIZE + HD_LV_LEN) * (int)sizeof(BlockHV));
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Bipolar HV Test: ---------------------------
+#define BIPOLAR_TRAIN 7         // Noisy copies bundled in each class
+
+void test_bipolar_hv()
+{
+    HVRng rng(110);
+    printf("\e[91m--- Test BIPOLAR HV ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    hdc.HV_type = 1;
+    bool passed = true;
+
+    HV binary_a, binary_b;
+    binary_a.randomize(rng);
+    binary_b.randomize(rng);
+    BipolarHV a, b;
+    a.from_binary(binary_a, 1);
+    b.from_binary(binary_b, 1);
+
+    // Binary forms in the SPM for the accelerated dot product
+    hvmemld((void*)((int*)spmaddrA), &binary_a.chunk[0], sizeof(binary_a));
+    hvmemld((void*)((int*)spmaddrB), &binary_b.chunk[0], sizeof(binary_b));
+
+    start_count();
+    int hamming_distance = hdc.similarity(binary_a, binary_b);
+    int binary_cycle = finish_count();
+
+    start_count();
+    int std_dot = hdc.dot(a, b);
+    int std_cycle = finish_count();
+
+    start_count();
+    int accl_dot = hdc.accl_dot(spmaddrA, spmaddrB);
+    int accl_cycle = finish_count();
+
+    printf("Binary Similarity: %d cycles\n", binary_cycle);
+    printf("Standard Execution: %d cycles\n", std_cycle);
+    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+
+    passed = std_dot == HV_SIZE_BIT - 2 * hamming_distance && accl_dot == std_dot;
+
+    // Binding of +1/-1 HVs is the XOR of the binary forms
+    HV bound = hdc.bind(a, b).to_binary();
+    HV xor_hv = hdc.bind(binary_a, binary_b);
+    for (int i = 0; i < HV_CHUNKS; i++)
+        if (bound.chunk[i] != xor_hv.chunk[i])
+            passed = false;
+
+    // Any int8 (including -128) and int16 values vs the plain loops
+    BipolarHV x, w, saturated;
+    BundledBipolarHV y;
+    int reference_dot = 0, reference_full_dot = 0, reference_bundled_dot = 0, x_sum = 0;
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        x.element[d] = (int8_t)(rand() % 256 - 128);
+        w.element[d] = (int8_t)(rand() % 256 - 128);
+        saturated.element[d] = -128;
+        y.element[d] = (int16_t)(rand() % 2001 - 1000);
+        reference_dot += x.element[d] * a.element[d];
+        reference_full_dot += x.element[d] * w.element[d];
+        x_sum += x.element[d];
+        reference_bundled_dot += y.element[d] * x.element[d];
+    }
+    passed = passed && hdc.dot(x, a) == reference_dot && hdc.dot(x, w) == reference_full_dot && hdc.dot(y, x) == reference_bundled_dot;
+    passed = passed && hdc.dot(saturated, saturated) == 128 * 128 * HV_SIZE_BIT && hdc.dot(saturated, x) == -128 * x_sum;
+
+    // Classes bundled without clipping from noisy copies of their prototypes, then searched
+    BipolarHV prototypes[HD_CV_LEN];
+    BundledBipolarHV class_vectors[HD_CV_LEN];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        prototypes[c] = hdc.bipolar_random();
+        for (int n = 0; n < BIPOLAR_TRAIN; n++) {
+            BipolarHV noisy = prototypes[c];
+            for (int d = 0; d < HV_SIZE_BIT / 4; d++)
+                noisy.element[rand() % HV_SIZE_BIT] *= -1;
+            passed &= hdc.bundle(class_vectors[c], noisy);
+        }
+    }
+    for (int c = 0; c < HD_CV_LEN; c++)
+        if (hdc.Search(prototypes[c], class_vectors) != c)
+            passed = false;
+    BipolarHV clipped = hdc.clip(class_vectors[0]);
+    passed = passed && hdc.dot(clipped, prototypes[0]) > HV_SIZE_BIT / 2;
+
+    // A sum reaching the int16 limits is accepted, one past them is rejected and the sums are unchanged
+    BundledBipolarHV full;
+    full.element[0] = INT16_MAX - 127;
+    full.element[1] = INT16_MIN + 128;
+    BipolarHV up, down;
+    up.element[0] = 127;
+    down.element[1] = -128;
+    passed = passed && hdc.bundle(full, up) && hdc.bundle(full, down);
+    passed = passed && !hdc.bundle(full, up) && !hdc.bundle(full, down);
+    passed = passed && full.element[0] == INT16_MAX && full.element[1] == INT16_MIN;
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Cosine Search Test: ---------------------------
+#define COSINE_TRAIN 3          // Training samples of the smallest class
+#define COSINE_TEST 20          // Test samples per class
+
+// Copy of an HV with 'flips' random bits flipped
+HV noisy_copy(const HV& hv, int flips)
+{
+    HV copy = hv;
+    for (int n = 0; n < flips; n++) {
+        int d = rand() % HV_SIZE_BIT;
+        copy.chunk[d / 32] ^= (1u << (d % 32));
+    }
+    return copy;
+}
+
+void test_cosine_search()
+{
+    HVRng rng(111);
+    printf("\e[91m--- Test COSINE SEARCH ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    // Each class has two sub-clusters, which the majority of the clipped class vectors blurs,
+    // and the number of training samples grows with the class index (imbalanced classes)
+    HV prototypes[HD_CV_LEN][2];
+    static ClassAccumulator class_vectors[HD_CV_LEN];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        prototypes[c][0].randomize(rng);
+        prototypes[c][1].randomize(rng);
+        for (int n = 0; n < COSINE_TRAIN + 4 * c; n++)
+            hdc.train(class_vectors[c], noisy_copy(prototypes[c][n % 2], HV_SIZE_BIT / 8));
+    }
+
+    // Incremental norm and bit-plane dot product vs the counters
+    HV query = noisy_copy(prototypes[0][0], HV_SIZE_BIT / 4);
+    long long norm2 = 0;
+    int reference_dot = 0;
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        int s = class_vectors[0].samples - 2 * class_vectors[0].counters.get_counter(d / 32, d % 32);
+        norm2 += s * s;
+        reference_dot += ((query.chunk[d / 32] >> (d % 32)) & 1 ? -s : s);
+    }
+    float expected_inv_norm = 1.0f / sqrtf((float)norm2);
+    float error = class_vectors[0].inv_norm - expected_inv_norm;
+    passed = (error < 0 ? -error : error) < expected_inv_norm * 1e-5f && hdc.dot(class_vectors[0], query) == reference_dot;
+
+    // A full class rejects the samples that would wrap its counters
+    static ClassAccumulator full_class;
+    for (int n = 0; n < (1 << SLICED_PLANES) - 1; n++)
+        passed &= hdc.train(full_class, query);
+    passed &= !hdc.train(full_class, query) && full_class.samples == (1 << SLICED_PLANES) - 1;
+    passed &= hdc.dot(full_class, query) == full_class.samples * HV_SIZE_BIT;
+
+    int hamming_correct = 0, cosine_correct = 0, hamming_cycle = 0, cosine_cycle = 0;
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        for (int n = 0; n < COSINE_TEST; n++) {
+            HV sample = noisy_copy(prototypes[c][n % 2], 2 * HV_SIZE_BIT / 5);
+            hdc.HV_similarity = 0;
+            start_count();
+            hamming_correct += hdc.Search(sample, class_vectors) == c;
+            hamming_cycle += finish_count();
+            hdc.HV_similarity = 1;
+            start_count();
+            cosine_correct += hdc.Search(sample, class_vectors) == c;
+            cosine_cycle += finish_count();
+        }
+    }
+    printf("Hamming Search: %d cycles/query, accuracy %d/%d\n", hamming_cycle / (HD_CV_LEN * COSINE_TEST), hamming_correct, HD_CV_LEN * COSINE_TEST);
+    printf("Cosine Search: %d cycles/query, accuracy %d/%d\n", cosine_cycle / (HD_CV_LEN * COSINE_TEST), cosine_correct, HD_CV_LEN * COSINE_TEST);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Mixed-Precision Class Test: ---------------------------
+#define MIXED_TRAIN 12          // Training samples per class
+#define MIXED_TEST 40           // Test samples per class
+
+// Exact score of a mixed-precision prototype: sum_d (1 - 2 q_d) (2 u_d - (2^bits - 1))
+int mixed_reference_score(const MixedPrecisionClass& prototype, const HV& query)
+{
+    int score = 0;
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        int u = 0;
+        for (int p = 0; p < prototype.bits; p++)
+            u |= ((prototype.plane[p][d / 32] >> (d % 32)) & 1) << p;
+        int w = 2 * u - ((1 << prototype.bits) - 1);
+        score += ((query.chunk[d / 32] >> (d % 32)) & 1) ? -w : w;
+    }
+    return score;
+}
+
+void test_mixed_precision()
+{
+    HVRng rng(112);
+    printf("\e[91m--- Test MIXED-PRECISION CLASS MEMORY ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    // One trained model: classes with three sub-clusters each, so their counters are far from binary
+    HV prototypes[HD_CV_LEN][3];
+    static ClassAccumulator class_vectors[HD_CV_LEN];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        for (int k = 0; k < 3; k++)
+            prototypes[c][k].randomize(rng);
+        for (int n = 0; n < MIXED_TRAIN; n++)
+            hdc.train(class_vectors[c], noisy_copy(prototypes[c][n % 3], HV_SIZE_BIT / 6));
+    }
+    static HV samples[HD_CV_LEN * MIXED_TEST];
+    for (int i = 0; i < HD_CV_LEN * MIXED_TEST; i++)
+        samples[i] = noisy_copy(prototypes[i % HD_CV_LEN][(i / HD_CV_LEN) % 3], 9 * HV_SIZE_BIT / 20);
+
+    // Precisions of the same model, each evaluated over all its planes and over its most significant ones
+    static MixedPrecisionClass memory[HD_CV_LEN];
+    int precisions[4] = {1, 2, 4, 8};
+    for (int i = 0; i < 4; i++) {
+        int bits = precisions[i];
+        for (int c = 0; c < HD_CV_LEN; c++)
+            memory[c] = hdc.quantize_class(class_vectors[c], bits);
+
+        for (int planes = bits; planes >= 1; planes /= 2) {
+            int correct = 0, total_planes = 0, cycles = 0;
+            for (int s = 0; s < HD_CV_LEN * MIXED_TEST; s++) {
+                int used_planes;
+                start_count();
+                int label = hdc.Search(samples[s], memory, planes, used_planes);
+                cycles += finish_count();
+                correct += label == s % HD_CV_LEN;
+                total_planes += used_planes;
+
+                // The early exit over all the planes gives the class of the exact scores
+                if (planes == bits) {
+                    int best = 0, best_score = mixed_reference_score(memory[0], samples[s]);
+                    for (int c = 1; c < HD_CV_LEN; c++) {
+                        int score = mixed_reference_score(memory[c], samples[s]);
+                        if (score > best_score) {
+                            best_score = score;
+                            best = c;
+                        }
+                    }
+                    passed &= label == best;
+                }
+            }
+            printf("%d-bit prototypes (%4d bytes/class), %d planes: accuracy %3d/%d, %.2f planes/query, %d cycles/query\n",
+                   bits, bits * HV_SIZE_BIT / 8, planes, correct, HD_CV_LEN * MIXED_TEST,
+                   (float)total_planes / (HD_CV_LEN * MIXED_TEST), cycles / (HD_CV_LEN * MIXED_TEST));
+        }
+    }
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Compact Model Test: ---------------------------
+#define COMPACT_TRAIN 40        // Training samples per class
+#define COMPACT_TEST 40         // Test samples per class
+
+// Features of a sample of class 'label': the levels of the class, each moved by one level with probability 1/2
+void generate_compact_sample(int features[DS_FEATURE_SIZE], const int class_levels[HD_CV_LEN][DS_FEATURE_SIZE], int label)
+{
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        int level = class_levels[label][i] + (rand() % 4 == 0) - (rand() % 4 == 0);
+        features[i] = level < 0 ? 0 : (level >= HD_LV_LEN ? HD_LV_LEN - 1 : level);
+    }
+}
+
+void test_compact_model()
+{
+    printf("\e[91m--- Test COMPACT MODEL ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    HV BaseVectors[DS_FEATURE_SIZE], LevelVectors[HD_LV_LEN];
+    hdc.generate_BaseHVs(BaseVectors);
+    hdc.generate_LevelVectors(LevelVectors);
+    int class_levels[HD_CV_LEN][DS_FEATURE_SIZE];
+    for (int c = 0; c < HD_CV_LEN; c++)
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            class_levels[c][i] = rand() % HD_LV_LEN;
+
+    // 1) Training of the full model
+    static ClassAccumulator class_vectors[HD_CV_LEN];
+    int features[DS_FEATURE_SIZE];
+    uint8_t levels[DS_FEATURE_SIZE];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        for (int n = 0; n < COMPACT_TRAIN; n++) {
+            generate_compact_sample(features, class_levels, c);
+            for (int i = 0; i < DS_FEATURE_SIZE; i++)
+                levels[i] = features[i];
+            hdc.train(class_vectors[c], hdc.encoding(levels, BaseVectors, LevelVectors));
+        }
+    }
+    static int test_features[HD_CV_LEN * COMPACT_TEST][DS_FEATURE_SIZE];
+    int full_correct = 0;
+    for (int s = 0; s < HD_CV_LEN * COMPACT_TEST; s++) {
+        generate_compact_sample(test_features[s], class_levels, s % HD_CV_LEN);
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            levels[i] = test_features[s][i];
+        full_correct += hdc.Search(hdc.encoding(levels, BaseVectors, LevelVectors), class_vectors) == s % HD_CV_LEN;
+    }
+
+    // 2) Accuracy and latency versus the kept dimensions
+    static CompactModel model;
+    for (int dimensions = HV_SIZE_BIT; dimensions >= 32; dimensions /= 2) {
+        passed &= hdc.compact_model(class_vectors, BaseVectors, LevelVectors, dimensions, model);
+        int correct = 0, cycles = 0;
+        for (int s = 0; s < HD_CV_LEN * COMPACT_TEST; s++) {
+            start_count();
+            HV query = hdc.compact_encoding(test_features[s], model);
+            int label = hdc.Search(query, model);
+            cycles += finish_count();
+            correct += label == s % HD_CV_LEN;
+
+            // The compact encoding is the gathered full encoding
+            for (int i = 0; i < DS_FEATURE_SIZE; i++)
+                levels[i] = test_features[s][i];
+            HV reference = hdc.gather(hdc.encoding(levels, BaseVectors, LevelVectors), model.gather, dimensions);
+            for (int c = 0; c < HV_CHUNKS; c++)
+                passed &= query.chunk[c] == reference.chunk[c];
+        }
+        // All the dimensions kept: same classification as the full model
+        if (dimensions == HV_SIZE_BIT)
+            passed &= correct == full_correct;
+        printf("D = %3d: accuracy %3d/%d, %d cycles/query (encoding + search)\n",
+               dimensions, correct, HD_CV_LEN * COMPACT_TEST, cycles / (HD_CV_LEN * COMPACT_TEST));
+    }
+
+    // Dimensions that are not whole chunks, or more than the HVs have, are rejected
+    passed &= !hdc.compact_model(class_vectors, BaseVectors, LevelVectors, 48, model) && model.dimensions == 0;
+    passed &= !hdc.compact_model(class_vectors, BaseVectors, LevelVectors, HV_SIZE_BIT + 32, model) && model.dimensions == 0;
+    passed &= !hdc.compact_model(class_vectors, BaseVectors, LevelVectors, 0, model);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Progressive Inference Test: ---------------------------
+void test_progressive_inference()
+{
+    printf("\e[91m--- Test PROGRESSIVE INFERENCE ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    HV BaseVectors[DS_FEATURE_SIZE], LevelVectors[HD_LV_LEN];
+    hdc.generate_BaseHVs(BaseVectors);
+    hdc.generate_LevelVectors(LevelVectors);
+    int class_levels[HD_CV_LEN][DS_FEATURE_SIZE];
+    for (int c = 0; c < HD_CV_LEN; c++)
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            class_levels[c][i] = rand() % HD_LV_LEN;
+
+    // 1) Training
+    static ClassAccumulator class_accumulators[HD_CV_LEN];
+    HV ClassVectors[HD_CV_LEN];
+    int features[DS_FEATURE_SIZE];
+    uint8_t levels[DS_FEATURE_SIZE];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        for (int n = 0; n < COMPACT_TRAIN; n++) {
+            generate_compact_sample(features, class_levels, c);
+            for (int i = 0; i < DS_FEATURE_SIZE; i++)
+                levels[i] = features[i];
+            hdc.train(class_accumulators[c], hdc.encoding(levels, BaseVectors, LevelVectors));
+        }
+        ClassVectors[c] = hdc.clip(class_accumulators[c].counters, class_accumulators[c].samples);
+    }
+
+    // 2) Full inference
+    static int test_features[HD_CV_LEN * COMPACT_TEST][DS_FEATURE_SIZE];
+    static int full_label[HD_CV_LEN * COMPACT_TEST];
+    int full_correct = 0, full_cycle = 0;
+    for (int s = 0; s < HD_CV_LEN * COMPACT_TEST; s++) {
+        generate_compact_sample(test_features[s], class_levels, s % HD_CV_LEN);
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            levels[i] = test_features[s][i];
+        start_count();
+        full_label[s] = hdc.Search(hdc.encoding(levels, BaseVectors, LevelVectors), ClassVectors);
+        full_cycle += finish_count();
+        full_correct += full_label[s] == s % HD_CV_LEN;
+    }
+    printf("Full inference:               accuracy %3d/%d, %5.2f words/query, %d cycles/query\n",
+           full_correct, HD_CV_LEN * COMPACT_TEST, (float)HV_CHUNKS, full_cycle / (HD_CV_LEN * COMPACT_TEST));
+
+    // 3) Progressive inference for decreasing confidence, FLT_MAX only stops when the result is final
+    float confidences[5] = {FLT_MAX, 4.0f, 3.0f, 2.0f, 1.0f};
+    for (int k = 0; k < 5; k++) {
+        int correct = 0, total_words = 0, cycles = 0;
+        for (int s = 0; s < HD_CV_LEN * COMPACT_TEST; s++) {
+            int words;
+            start_count();
+            int label = hdc.progressive_inference(test_features[s], BaseVectors, LevelVectors, ClassVectors, confidences[k], words);
+            cycles += finish_count();
+            correct += label == s % HD_CV_LEN;
+            total_words += words;
+            if (k == 0)
+                passed &= label == full_label[s];
+            passed &= words > 0 && words <= HV_CHUNKS;
+        }
+        if (k == 0)
+            printf("Progressive, final margin:    ");
+        else
+            printf("Progressive, confidence %.1f: ", confidences[k]);
+        printf("accuracy %3d/%d, %5.2f words/query, %d cycles/query\n",
+               correct, HD_CV_LEN * COMPACT_TEST, (float)total_words / (HD_CV_LEN * COMPACT_TEST), cycles / (HD_CV_LEN * COMPACT_TEST));
+    }
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Hierarchical Memory Test: ---------------------------
+#define HIER_CLASSES 512        // Fine-grained classes
+#define HIER_FAMILIES 32        // Families of similar classes the classes are drawn from
+#define HIER_GROUPS 32          // Groups of the hierarchical memory
+#define HIER_QUERIES 256
+
+void test_hierarchical_memory()
+{
+    HVRng rng(113);
+    printf("\e[91m--- Test HIERARCHICAL MEMORY ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    // Classes: noisy copies of the HVs of their family, queries: noisy copies of the classes
+    static HV families[HIER_FAMILIES], classes[HIER_CLASSES], queries[HIER_QUERIES];
+    static int flat_label[HIER_QUERIES];
+    for (int f = 0; f < HIER_FAMILIES; f++)
+        families[f].randomize(rng);
+    for (int c = 0; c < HIER_CLASSES; c++)
+        classes[c] = noisy_copy(families[rand() % HIER_FAMILIES], HV_SIZE_BIT / 6);
+    for (int q = 0; q < HIER_QUERIES; q++)
+        queries[q] = noisy_copy(classes[rand() % HIER_CLASSES], HV_SIZE_BIT / 6);
+
+    // 1) Flat search
+    int flat_cycle = 0;
+    for (int q = 0; q < HIER_QUERIES; q++) {
+        start_count();
+        flat_label[q] = hdc.cleanup(queries[q], classes, HIER_CLASSES, HV_CHUNKS);
+        flat_cycle += finish_count();
+    }
+    printf("Flat search:      %4d comparisons/query, %d cycles/query\n", HIER_CLASSES, flat_cycle / HIER_QUERIES);
+
+    // 2) Build: every class in exactly one group
+    static HierarchicalMemory memory;
+    passed &= !hdc.build_hierarchy(classes, HIER_MAX_CLASSES + 1, HIER_GROUPS, 5, memory) && memory.groups == 0;
+    passed &= !hdc.build_hierarchy(classes, HIER_CLASSES, HIER_MAX_GROUPS + 1, 5, memory);
+    passed &= hdc.build_hierarchy(classes, HIER_CLASSES, HIER_GROUPS, 5, memory);
+    int seen[HIER_CLASSES] = {0};
+    for (int m = 0; m < memory.group_start[HIER_GROUPS]; m++)
+        seen[memory.member[m]]++;
+    for (int c = 0; c < HIER_CLASSES; c++)
+        passed &= seen[c] == 1;
+
+    // 3) Recall (agreement with the flat search) and speed-up versus the groups searched
+    for (int top_groups = 1; top_groups <= HIER_GROUPS; top_groups *= 2) {
+        int recalled = 0, compared = 0, cycles = 0;
+        for (int q = 0; q < HIER_QUERIES; q++) {
+            int query_compared;
+            start_count();
+            int label = hdc.Search(queries[q], classes, memory, top_groups, query_compared);
+            cycles += finish_count();
+            recalled += label == flat_label[q];
+            compared += query_compared;
+        }
+        // All the groups searched: same result as the flat search
+        if (top_groups == HIER_GROUPS)
+            passed &= recalled == HIER_QUERIES;
+        printf("Top %2d groups:    %4d comparisons/query, %d cycles/query, recall %3d/%d, speed-up %.1fx\n",
+               top_groups, compared / HIER_QUERIES, cycles / HIER_QUERIES, recalled, HIER_QUERIES,
+               (float)HIER_CLASSES * HIER_QUERIES / compared);
+    }
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Ensemble Test: ---------------------------
+#define ENSEMBLE_TRAIN 40       // Training samples per class
+#define ENSEMBLE_TEST 40        // Test samples per class
+
+// Features in [0, 1) of a sample of class 'label': the centers of the class plus uniform noise
+void generate_ensemble_sample(float features[DS_FEATURE_SIZE], const float centers[HD_CV_LEN][DS_FEATURE_SIZE], int label)
+{
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        float value = centers[label][i] + ((rand() % 1000) / 1000.0f - 0.5f) * 0.25f;
+        features[i] = value < 0 ? 0 : (value > 0.999f ? 0.999f : value);
+    }
+}
+
+void test_ensemble()
+{
+    printf("\e[91m--- Test ENSEMBLE ---\e[39m\n");
+    bool passed = true;
+    UniformQuantizer quantizer(0.0f, 1.0f, HD_LV_LEN);
+    float centers[HD_CV_LEN][DS_FEATURE_SIZE];
+    for (int c = 0; c < HD_CV_LEN; c++)
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            centers[c][i] = (rand() % 1000) / 1000.0f;
+
+    // Members: two item memories (seeds), each used by a full and by a reduced dimensionality model
+    const int members = 4;
+    uint32_t seeds[2] = {11, 22};
+    int member_memory[members] = {0, 0, 1, 1};
+    int member_dimensions[members] = {HV_SIZE_BIT, HV_SIZE_BIT / 2, HV_SIZE_BIT, HV_SIZE_BIT / 4};
+    static HV BaseVectors[2][DS_FEATURE_SIZE], LevelVectors[2][HD_LV_LEN];
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    for (int m = 0; m < 2; m++) {
+        hdc.seed(seeds[m]);
+        hdc.generate_BaseHVs(BaseVectors[m]);
+        hdc.generate_LevelVectors(LevelVectors[m]);
+    }
+
+    // 1) Training: one class memory per item memory, the reduced models use its first words
+    HV ClassVectors[2][HD_CV_LEN];
+    float features[DS_FEATURE_SIZE];
+    uint8_t levels[DS_FEATURE_SIZE];
+    for (int m = 0; m < 2; m++) {
+        static ClassAccumulator class_accumulators[HD_CV_LEN];
+        for (int c = 0; c < HD_CV_LEN; c++) {
+            class_accumulators[c] = ClassAccumulator();
+            for (int n = 0; n < ENSEMBLE_TRAIN; n++) {
+                generate_ensemble_sample(features, centers, c);
+                for (int i = 0; i < DS_FEATURE_SIZE; i++)
+                    levels[i] = quantizer.quantize(features[i]);
+                hdc.train(class_accumulators[c], hdc.encoding(levels, BaseVectors[m], LevelVectors[m]));
+            }
+            ClassVectors[m][c] = hdc.clip(class_accumulators[c].counters, class_accumulators[c].samples);
+        }
+    }
+
+    static float test_features[HD_CV_LEN * ENSEMBLE_TEST][DS_FEATURE_SIZE];
+    static int labels[HD_CV_LEN * ENSEMBLE_TEST];
+    const int samples = HD_CV_LEN * ENSEMBLE_TEST;
+    for (int s = 0; s < samples; s++)
+        generate_ensemble_sample(test_features[s], centers, s % HD_CV_LEN);
+
+    // 2) Cost versus members: each member quantizing, encoding and searching on its own, and the ensemble
+    static Ensemble ensemble;
+    for (int m = 0; m < 2; m++)
+        ensemble.add_item_memory(BaseVectors[m], LevelVectors[m]);
+    for (int k = 0; k < members; k++) {
+        ensemble.add_member(member_memory[k], member_dimensions[k], ClassVectors[member_memory[k]]);
+
+        int separate_cycle = 0, member_correct = 0;
+        for (int s = 0; s < samples; s++) {
+            start_count();
+            for (int i = 0; i < DS_FEATURE_SIZE; i++)
+                levels[i] = quantizer.quantize(test_features[s][i]);
+            HV query = hdc.encoding(levels, BaseVectors[member_memory[k]], LevelVectors[member_memory[k]]);
+            int label = hdc.cleanup(query, ClassVectors[member_memory[k]], HD_CV_LEN, member_dimensions[k] / 32);
+            separate_cycle += finish_count();
+            member_correct += label == s % HD_CV_LEN;
+
+            // The ensemble member predicts the same class
+            int predictions[ENSEMBLE_MAX_MEMBERS];
+            hdc.ensemble_inference(levels, ensemble, predictions);
+            passed &= predictions[k] == label;
+        }
+        static int member_cycle[members];
+        member_cycle[k] = separate_cycle;
+        int total_separate = 0;
+        for (int j = 0; j <= k; j++)
+            total_separate += member_cycle[j];
+
+        start_count();
+        hdc.ensemble_inference_batch(test_features, samples, quantizer, ensemble, labels);
+        int ensemble_cycle = finish_count();
+        int correct = 0;
+        for (int s = 0; s < samples; s++)
+            correct += labels[s] == s % HD_CV_LEN;
+
+        printf("Member %d (item memory %d, D = %3d): accuracy %3d/%d\n", k, member_memory[k], member_dimensions[k], member_correct, samples);
+        printf("  %d members: separate %d cycles/sample, ensemble %d cycles/sample, ensemble accuracy %3d/%d\n",
+               k + 1, total_separate / samples, ensemble_cycle / samples, correct, samples);
+    }
+
+    // Out of range members and item memories are rejected and leave the ensemble unchanged
+    static Ensemble invalid;
+    invalid.add_item_memory(BaseVectors[0], LevelVectors[0]);
+    passed &= invalid.add_member(1, HV_SIZE_BIT, ClassVectors[0]) == -1;
+    passed &= invalid.add_member(0, 16, ClassVectors[0]) == -1;
+    passed &= invalid.add_member(0, HV_SIZE_BIT + 32, ClassVectors[0]) == -1;
+    passed &= invalid.add_member(0, 48, ClassVectors[0]) == -1;
+    for (int k = 0; k < ENSEMBLE_MAX_MEMBERS; k++)
+        passed &= invalid.add_member(0, 32, ClassVectors[0]) == k;
+    passed &= invalid.add_member(0, 32, ClassVectors[0]) == -1 && invalid.members == ENSEMBLE_MAX_MEMBERS;
+    for (int m = 1; m < ENSEMBLE_MAX_MEMORIES; m++)
+        invalid.add_item_memory(BaseVectors[1], LevelVectors[1]);
+    passed &= invalid.add_item_memory(BaseVectors[1], LevelVectors[1]) == -1 && invalid.item_memories == ENSEMBLE_MAX_MEMORIES;
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Regression Test: ---------------------------
+#define REG_TRAIN 400
+#define REG_TEST 200
+
+// Non-linear target of zero centered features in [-1, 1]
+float regression_target(const float features[DS_FEATURE_SIZE])
+{
+    return sinf(3.14159f * features[0]) * 0.5f + features[1] * features[2] + 0.25f * features[3];
+}
+
+void test_regression()
+{
+    printf("\e[91m--- Test REGRESSION ---\e[39m\n");
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+    bool passed = true;
+
+    // Samples quantized and encoded with the spatial encoder
+    UniformQuantizer quantizer(-1.0f, 1.0f, HD_LV_LEN);
+    HV BaseVectors[DS_FEATURE_SIZE], LevelVectors[HD_LV_LEN];
+    hdc.generate_BaseHVs(BaseVectors);
+    hdc.generate_LevelVectors(LevelVectors);
+    uint8_t levels[DS_FEATURE_SIZE];
+    static HV train_hv[REG_TRAIN], test_hv[REG_TEST];
+    static float train_y[REG_TRAIN], test_y[REG_TEST], single[REG_TEST], batch[REG_TEST];
+    float features[DS_FEATURE_SIZE];
+    for (int s = 0; s < REG_TRAIN + REG_TEST; s++) {
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            features[i] = (rand() % 2001) / 1000.0f - 1.0f;
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            levels[i] = quantizer.quantize(features[i]);
+        if (s < REG_TRAIN) {
+            train_hv[s] = hdc.encoding(levels, BaseVectors, LevelVectors);
+            train_y[s] = regression_target(features);
+        } else {
+            test_hv[s - REG_TRAIN] = hdc.encoding(levels, BaseVectors, LevelVectors);
+            test_y[s - REG_TRAIN] = regression_target(features);
+        }
+    }
+    float mean = 0, variance = 0;
+    for (int s = 0; s < REG_TEST; s++)
+        mean += test_y[s] / REG_TEST;
+    for (int s = 0; s < REG_TEST; s++)
+        variance += (test_y[s] - mean) * (test_y[s] - mean) / REG_TEST;
+    printf("Target variance: %.4f\n", variance);
+
+    // Single model and clustered models: mean squared error on the test set
+    int cluster_counts[2] = {1, 4};
+    static RegressionModel model(1, 0.2f);
+    int batch_cycle = 0;
+    for (int m = 0; m < 2; m++) {
+        model.reset(cluster_counts[m], 0.2f);
+        hdc.regression_init(model, train_hv, REG_TRAIN);
+        hdc.regression_train(model, train_hv, train_y, REG_TRAIN, 10);
+
+        start_count();
+        hdc.regression_predict_batch(model, test_hv, REG_TEST, batch);
+        batch_cycle = finish_count();
+        float mse = 0;
+        for (int s = 0; s < REG_TEST; s++) {
+            single[s] = hdc.regression_predict(model, test_hv[s]);
+            passed &= fabsf(single[s] - batch[s]) < 1e-5f;
+            mse += (batch[s] - test_y[s]) * (batch[s] - test_y[s]) / REG_TEST;
+        }
+        passed &= mse < variance / 2;
+        printf("%d cluster(s): test MSE %.4f (%.0f%% of the variance)\n", cluster_counts[m], mse, 100 * mse / variance);
+    }
+
+    // More samples in one epoch than the cluster counters hold: the cluster is the majority of all of them
+    static HV long_series[3 * REG_TRAIN];
+    static float long_targets[3 * REG_TRAIN];
+    for (int s = 0; s < 3 * REG_TRAIN; s++) {
+        long_series[s] = train_hv[s % REG_TRAIN];
+        long_targets[s] = train_y[s % REG_TRAIN];
+    }
+    model.reset(1, 0.2f);
+    hdc.regression_init(model, long_series, 3 * REG_TRAIN);
+    hdc.regression_train(model, long_series, long_targets, 3 * REG_TRAIN, 1);
+    HV majority;
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        int ones = 0;
+        for (int s = 0; s < REG_TRAIN; s++)
+            ones += (train_hv[s].chunk[d / 32] >> (d % 32)) & 1;
+        if (2 * ones > REG_TRAIN)
+            majority.chunk[d / 32] |= (int)(1u << (d % 32));
+    }
+    int center_distance = hdc.similarity(model.center[0], majority);
+    printf("Cluster of %d samples in one epoch: %d bits from their majority\n", 3 * REG_TRAIN, center_distance);
+    passed &= center_distance <= HV_SIZE_BIT / 64;
+
+    // Out of range cluster counts are clamped
+    model.reset(REG_MAX_CLUSTERS + 1, 0.2f);
+    passed &= model.clusters == REG_MAX_CLUSTERS;
+    model.reset(0, 0.2f);
+    passed &= model.clusters == 1;
+
+    // Throughput against the classifier path on the same HVs
+    HV ClassVectors[HD_CV_LEN];
+    for (int c = 0; c < HD_CV_LEN; c++)
+        ClassVectors[c] = train_hv[c];
+    static int classes[REG_TEST];
+    start_count();
+    for (int s = 0; s < REG_TEST; s++)
+        classes[s] = hdc.Search(test_hv[s], ClassVectors);
+    int search_cycle = finish_count();
+    (void)classes;        // Only timed
+    printf("Batched regression: %d cycles/sample, %d samples/s at %d MHz\n", batch_cycle / REG_TEST,
+           batch_cycle ? (int)((long long)REG_TEST * CORE_CLOCK_MHZ * 1000000 / batch_cycle) : 0, CORE_CLOCK_MHZ);
+    printf("Classifier Search:  %d cycles/sample, %d samples/s at %d MHz\n", search_cycle / REG_TEST,
+           search_cycle ? (int)((long long)REG_TEST * CORE_CLOCK_MHZ * 1000000 / search_cycle) : 0, CORE_CLOCK_MHZ);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
+}
+
+// --------------------------- Temporal Encoding Test: ---------------------------
+void test_temporal_encoding()
+{
+    printf("\e[91m--- Test TEMPORAL ENCODING, N_GRAM_SIZE:%d ---\e[39m\n", N_GRAM_SIZE);
+    HDC_op hdc(HV_SIZE_BIT, DS_FEATURE_SIZE, HD_LV_LEN);
+
+    HV base_vectors[DS_FEATURE_SIZE];
+    HV level_vectors[HD_LV_LEN];
+
+    // Generate base and level vectors
+    hdc.generate_BaseHVs(base_vectors);
+    hdc.generate_LevelVectors(level_vectors);
+
+    // Store the base and level vectors in the SPM
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        hvmemld((void*)((int*)spmaddrA+i*HV_CHUNKS * 4), &base_vectors[i].chunk[0], HV_CHUNKS * 4);
+    for (int i = 0; i < HD_LV_LEN; i++)
+        hvmemld((void*)((int*)spmaddrB+i*HV_CHUNKS * 4), &level_vectors[i].chunk[0], HV_CHUNKS * 4);
+
+    // Random sequence of quantized samples
+    const int STEPS = 3 * N_GRAM_SIZE;
+    int sequence[STEPS][DS_FEATURE_SIZE];
+    for (int t = 0; t < STEPS; t++)
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            sequence[t][i] = rand() % HD_LV_LEN;
+
+    // ---- Batch encoding of the first N-gram ----
+    int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        for (int k = 0; k < N_GRAM_SIZE; k++)
+            quantized_features[i][k] = sequence[k][i];
+
+    start_count();
+    HV encoded_hv = hdc.temporal_encoding(quantized_features, base_vectors, level_vectors);
+    int std_cycle = finish_count();
+    #if DEBUG==1
+        printf("Encoded HV -->  ");
+        encoded_hv.print();
+    #endif
+
+    start_count();
+    HV accl_encoded_HV = hdc.accl_temporal_encoding(quantized_features, spmaddrA, spmaddrB);
+    int accl_cycle = finish_count();
+    #if DEBUG==1
+        printf("Accl Encoded HV -->  ");
+        accl_encoded_HV.print();
+    #endif
+
+    printf("Standard Execution: %d cycles\n", std_cycle);
+    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+
+    bool passed = true;
+    for (int i = 0; i < HV_CHUNKS; i++)
+        if (encoded_hv.chunk[i] != accl_encoded_HV.chunk[i])
+            passed = false;
+
+    // ---- Streaming encoding: each step must match the batch encoding of the last N_GRAM_SIZE steps ----
+    NGramState state;
+    NGramState accl_state;
+    int step_cycle = 0, accl_step_cycle = 0;
+    for (int t = 0; t < STEPS; t++) {
+        start_count();
+        HV stream_hv = hdc.temporal_encoding_step(sequence[t], base_vectors, level_vectors, state);
+        step_cycle = finish_count();
+
+        start_count();
+        HV accl_stream_hv = hdc.accl_temporal_encoding_step(sequence[t], spmaddrA, spmaddrB, accl_state);
+        accl_step_cycle = finish_count();
+
+        if (t < N_GRAM_SIZE - 1)
+            continue;
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            for (int k = 0; k < N_GRAM_SIZE; k++)
+                quantized_features[i][k] = sequence[t - N_GRAM_SIZE + 1 + k][i];
+        HV reference = hdc.temporal_encoding(quantized_features, base_vectors, level_vectors);
+        for (int i = 0; i < HV_CHUNKS; i++)
+            if (reference.chunk[i] != stream_hv.chunk[i] || reference.chunk[i] != accl_stream_hv.chunk[i])
+                passed = false;
+    }
+    printf("Streaming Step Execution: %d cycles\n", step_cycle);
+    printf("Accelerated Streaming Step Execution: %d cycles\n", accl_step_cycle);
+
+    // TEST CHECK
+    printf("TEST CHECK -->  ");
+    if (passed)
+        printf("\e[32mTEST PASSED\e[39m\n\n");
+    else
+        printf("\e[31mTEST FAILED\e[39m\n\n");
 }
 
 // --------------------------- Training Test: ---------------------------
@@ -575,6 +2476,7 @@ void test_training()
 // --------------------------- Inference Test: ---------------------------
 void test_inference()
 {
+    HVRng rng(114);
     printf("\e[91m--- Test INFERENCE ---\e[39m\n");
     // Generate the quantization levels
     float quantization_levels[HD_LV_LEN];
@@ -591,7 +2493,7 @@ void test_inference()
     HV ClassVectors[HD_CV_LEN];
 
     for (int i = 0; i < HD_CV_LEN; i++)
-        ClassVectors[i].randomize();
+        ClassVectors[i].randomize(rng);
         
     BundledHV zero_HV;
     // Generate base and level vectors
@@ -3,8 +3,40 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <stdint.h>
 #include "hdc_defines.hpp"
 
+// Counter-based generator: the same (seed, stream, counter) always gives the same 32 random bits,
+// so any word of any HV can be regenerated on demand without storing it
+uint32_t hv_hash(uint32_t seed, uint32_t stream, uint32_t counter);
+
+// xoshiro128** generator: full 32-bit words, per-instance state, so every thread (or model)
+// can own a reproducible stream instead of sharing the hidden state of rand()
+struct HVRng {
+    uint32_t s[4];
+
+    // Default constructor: fixed seed
+    HVRng();
+
+    // Seeded constructor
+    HVRng(uint32_t seed);
+
+    // Re-seed the generator
+    void seed(uint32_t seed);
+
+    // Next 32 random bits
+    uint32_t next();
+
+    // Uniform integer in [0, n)
+    uint32_t bounded(uint32_t n);
+
+    // Fill n words with random bits
+    void fill(int* dst, int n);
+
+    // Advance by 2^64 draws: gives non-overlapping streams to parallel generators
+    void jump();
+};
+
 struct HV {
     int chunk[HV_CHUNKS];
 
@@ -17,9 +49,16 @@ struct HV {
     // Define the assignment operator
     HV& operator=(const HV& other);
 
-    // Define the randomize function
+    // Define the randomize function (shared default generator, not thread safe): use randomize(HVRng&)
+    [[deprecated("shared global generator, not thread safe: use randomize(HVRng&)")]]
     void randomize();
 
+    // Randomize with a given generator
+    void randomize(HVRng& rng);
+
+    // Deterministic randomization: word i is hv_hash(seed, stream, i)
+    void randomize(uint32_t seed, uint32_t stream);
+
     // Print Operator, bit by bit
     void print();
 };
@@ -39,9 +78,114 @@ struct BundledHV {
     // Define the assignment operator
     BundledHV& operator=(const HV& other);
 
+    // Counter of the element at bit position 'bit' (0 = LSB) of HV chunk 'chunk'
+    int get_counter(int chunk, int bit) const;
+
+    // Overwrite the counter of the element at bit position 'bit' of HV chunk 'chunk'
+    void set_counter(int chunk, int bit, int value);
+
     // Print Operator, bit by bit
     void print();
 };
 
+// Bit-sliced counters: plane p holds bit p of the counters of all the elements, so an HV is
+// added with a word-wide ripple carry and the majority is a word-wide comparison.
+struct SlicedHV {
+    int plane[SLICED_PLANES][HV_CHUNKS];
+    int count;  // HVs added with add()
+
+    // Default constructor: Initializes all the counters to zero
+    SlicedHV();
+
+    // Increment the counters of the elements set in the HV
+    void add(const HV& hv);
+
+    // Increment the counters of the elements set in 'bits', in HV chunk 'chunk' (count is not updated)
+    void add_chunk(int chunk, uint32_t bits);
+
+    // Counter of the element at bit position 'bit' (0 = LSB) of HV chunk 'chunk'
+    int get_counter(int chunk, int bit) const;
+
+    // HV with the elements whose counter is greater than threshold
+    HV threshold(int threshold) const;
+};
+
+// Sparse binary HV: sorted positions of its ones, at most SPARSE_MAX_ONES of them (SPARSE_MAX_DENSITY % of
+// HV_SIZE_BIT): 16 bits per position give 4/5 of the size of a dense HV, plus a 16-bit count
+struct SparseHV {
+    uint16_t index[SPARSE_MAX_ONES];
+    uint16_t ones;
+
+    // Default constructor: no ones
+    SparseHV();
+
+    // 'ones' distinct random positions, clamped to SPARSE_MAX_ONES
+    void randomize(HVRng& rng, int ones);
+
+    // Dense HV with the same ones
+    HV to_dense() const;
+
+    // Positions of the ones of a dense HV, the first SPARSE_MAX_ONES if it has more
+    void from_dense(const HV& hv);
+
+    // Print Operator, positions of the ones
+    void print();
+};
+
+// Block-sparse HV: BLOCK_COUNT blocks of BLOCK_LEN positions with exactly one active position each.
+// The active positions are stored as bytes, four per word, so that the operations work on four
+// blocks at a time (byte b of the HV is byte b % 4 of word b / 4, from the least significant).
+#define BLOCK_WORDS (BLOCK_COUNT / 4)
+
+struct BlockHV {
+    uint32_t word[BLOCK_WORDS];
+
+    // Default constructor: position 0 active in every block
+    BlockHV();
+
+    // Active position of a block
+    int get(int block) const;
+
+    // Set the active position of a block
+    void set(int block, int position);
+
+    // Random active positions
+    void randomize(HVRng& rng);
+
+    // Dense HV with bit block * BLOCK_LEN + position set for each block
+    HV to_dense() const;
+
+    // Print Operator, active position of each block
+    void print();
+};
+
+// Bipolar HV: one int8 element per dimension, +1/-1 for the HVs of the item memories.
+// Element d corresponds to bit d % 32 of chunk d / 32 of a binary HV, bit 0 being +1 and bit 1 being -1,
+// so binding (multiplication) of +1/-1 HVs matches the XOR of their binary forms.
+struct BipolarHV {
+    int8_t element[HV_SIZE_BIT];
+
+    // Default constructor: Initializes all data elements to zero
+    BipolarHV();
+
+    // +value / -value from the bits of a binary HV
+    void from_binary(const HV& hv, int value);
+
+    // Binary HV of the signs: bit set for the negative elements
+    HV to_binary() const;
+
+    // Print Operator, element by element
+    void print();
+};
+
+// Bundled bipolar HV: int16 sums of the bundled elements, not clipped until needed
+// (up to 32767 / |element| HVs can be bundled, HDC_op::bundle() rejects an HV that would wrap a sum)
+struct BundledBipolarHV {
+    int16_t element[HV_SIZE_BIT];
+
+    // Default constructor: Initializes all data elements to zero
+    BundledBipolarHV();
+};
+
 #endif // HV_STRUCT_HPP
 
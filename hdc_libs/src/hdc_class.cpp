@@ -1,4 +1,9 @@
+#include <float.h>
+#include <math.h>
 #include "hdc_class.hpp"
+#if defined(__AVX2__) || defined(__AVX512VNNI__)
+    #include <immintrin.h>
+#endif
 
 // --------------------------- Performance counting: --------------------------- 
 // Count functions:
@@ -30,8 +35,8 @@ inline int finish_count(){
 
 // Function to generate the quantization levels
 void generate_quantization_levels(float min, float max, int levels, float LevelList[HD_LV_LEN]) {
-    double length = max - min;
-    double gap = length / levels;
+    float length = max - min;
+    float gap = length / levels;
     for (int level = 0; level < levels - 1; ++level) {
         LevelList[level] = min + level * gap;
     }
@@ -56,12 +61,23 @@ HDC_op::HDC_op(int dimensionality, int features, int levels) {
     HV_SIZE = dimensionality;
     num_levels = levels;
     num_features = features;
+    lv_technique = 0;
+    density = 0;
+    sparsity_factor = 0.05f;
+    HV_type = 0;
+    base_value = 1;
+    HV_similarity = 0;
+}
+
+// Seed the generator of the base and level HVs: the same seed gives the same model
+void HDC_op::seed(uint32_t seed) {
+    rng.seed(seed);
 }
 
 // Base HVs
 void HDC_op::generate_BaseHVs(HV baseVectors[DS_FEATURE_SIZE]) {
     for (int vec = 0; vec < DS_FEATURE_SIZE; vec++)
-        baseVectors[vec].randomize();
+        baseVectors[vec].randomize(rng);
 }
 
 // Similarity
@@ -73,7 +89,7 @@ int HDC_op::similarity(HV HV1, HV HV2) {
         xor_HV.chunk[i] = HV1.chunk[i] ^ HV2.chunk[i];
 
     for (int i = 0; i < HV_SIZE / 32; i++) {
-        long long x = xor_HV.chunk[i];
+        uint32_t x = (uint32_t)xor_HV.chunk[i];
         int count;
         for (count = 0; x; count++)
             x &= x - 1;
@@ -124,6 +140,21 @@ HV HDC_op::permutation(HV hv, int shift) {
     return hv;
 }
 
+// Positional Key: rho^index(seed) for any index.
+// The permutation only shifts by less than 32 bits, so rho^index is split in a rotation by whole chunks
+// (rho^32 moves every chunk to the next one) followed by a permutation by the remaining bits.
+HV HDC_op::positional_key(HV seed, int index)
+{
+    int effective_shift = index % (HV_CHUNKS * 32);
+    int chunk_shift = effective_shift / 32;
+    HV key;
+
+    for (int i = 0; i < HV_CHUNKS; i++)
+        key.chunk[(i + chunk_shift) % (HV_CHUNKS)] = seed.chunk[i];
+
+    return this->permutation(key, effective_shift % 32);
+}
+
 // Bundling
 BundledHV HDC_op::bundle(const BundledHV& HV1, const HV& HV2) const {
     int j = HV_CHUNKS - 1;
@@ -185,7 +216,7 @@ int HDC_op::Search(HV QueryHV, HV associativeMemory[HD_CV_LEN]) {
             xor_HV.chunk[i] = associativeMemory[j].chunk[i] ^ QueryHV.chunk[i];
         }
         for (int i = 0; i < HV_SIZE / 32; i++) {
-            long long x = xor_HV.chunk[i];
+            uint32_t x = (uint32_t)xor_HV.chunk[i];
             int count;
             for (count = 0; x; count++){
                 x &= x - 1;
@@ -207,45 +238,60 @@ int HDC_op::Search(HV QueryHV, HV associativeMemory[HD_CV_LEN]) {
 
 
 // --------------------Level HVs----------------------
+// All the techniques are built on a single random permutation of the bit positions, generated in O(D)
+// with Fisher-Yates and sliced into the sets of bits flipped (or set) at each level:
+// 0: linear, each level flips HV_SIZE_BIT / (2 * num_levels) new bits of the previous level
+// 1: approximately linear, as linear but with each slice boundary jittered by up to half a slice
+// 2: thermometer, level l sets the first l * HV_SIZE_BIT / (num_levels - 1) bits of the permutation
 void HDC_op::generate_LevelVectors(HV LevelVectors[HD_LV_LEN])
-{                   
-    // Linear encoding
-    // the first level vector is randomly initialized 
-    int change_ratio;
-    change_ratio = HV_SIZE_BIT / 2;   
-    int indexVector[HV_SIZE_BIT];
+{
+    // Random permutation of the bit positions
+    uint16_t indexVector[HV_SIZE_BIT];
     for (int i = 0; i < HV_SIZE_BIT; i++)
-        indexVector[i] = 1;
+        indexVector[i] = i;
+    for (int i = HV_SIZE_BIT - 1; i > 0; i--) {
+        int j = rng.bounded(i + 1);
+        uint16_t tmp = indexVector[i];
+        indexVector[i] = indexVector[j];
+        indexVector[j] = tmp;
+    }
+
+    if (lv_technique == 2) {
+        // Thermometer encoding: the first level is all zeros and the last one all ones
+        LevelVectors[0] = HV();
+        for (int level = 1; level < num_levels; level++) {
+            LevelVectors[level] = LevelVectors[level - 1];
+            int first = (level - 1) * HV_SIZE_BIT / (num_levels - 1);
+            int last = level * HV_SIZE_BIT / (num_levels - 1);
+            for (int i = first; i < last; i++)
+                LevelVectors[level].chunk[indexVector[i] / 32] |= (1u << (indexVector[i] % 32));
+        }
+        return;
+    }
 
-    // Flipping random change_ratio bits
-    LevelVectors[0].randomize();
+    // Linear encoding
+    // the first level vector is randomly initialized 
+    LevelVectors[0].randomize(rng);
 
     // The other level vectors are obtained flipping a number of bits equal to int(HD_DIM / (2 * totalLevel))
-    // starting from the previous level vector. However, the same element can not be flipped 2 times
-    change_ratio = HV_SIZE_BIT / (2 * num_levels);
+    // starting from the previous level vector. The flipped bits are consecutive slices of the permutation,
+    // so the same element can not be flipped 2 times
+    int change_ratio = HV_SIZE_BIT / (2 * num_levels);
+    int first = 0;
     for (int level = 1; level < num_levels; level++)
     {
-        LevelVectors[level] = LevelVectors[level - 1];
-        int i=0;
-        while (i < change_ratio)
-        {
-            int index = rand() % HV_SIZE_BIT;
-            if (indexVector[index] == 1)
-            {                
-                indexVector[index] = 0;
-                i++;
-
-                if (LevelVectors[level - 1].chunk[index / 32] & (1 << (index % 32))) {
-                    // If the bit is 1, set it to 0
-                    LevelVectors[level].chunk[index / 32] &= ~(1 << (index % 32));
-                } else {
-                    // If the bit is 0, set it to 1
-                    LevelVectors[level].chunk[index / 32] |= 1 << (index % 32);
-                }
-
-
-            }
+        int last = level * change_ratio;
+        if (lv_technique == 1) {
+            // Approximately linear: jittered boundary, kept monotonic
+            last += (int)rng.bounded(2 * (change_ratio / 2) + 1) - change_ratio / 2;
+            if (last < first)
+                last = first;
         }
+
+        LevelVectors[level] = LevelVectors[level - 1];
+        for (int i = first; i < last; i++)
+            LevelVectors[level].chunk[indexVector[i] / 32] ^= (1u << (indexVector[i] % 32));
+        first = last;
     }
 
 } 
@@ -399,229 +445,2347 @@ HV HDC_op::accl_encoding(int quantized_features[DS_FEATURE_SIZE], int bv_start_a
 }
 // --------------------End Encoding----------------------
 
-// --------------------Temporal Encoding----------------------
-HV HDC_op::temporal_encoding(int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN])
+// --------------------Procedural Encoding----------------------
+// Spatial encoding with base and level vectors regenerated on demand by the procedural item memory
+// Input: quantized_features, item_memory
+// Output: HDC vector, identical to encoding() with the materialized base and level vectors
+HV HDC_op::encoding(int quantized_features[DS_FEATURE_SIZE], ProceduralItemMemory& item_memory)
 {
     BundledHV Encoded_HV;
-    HV Clipped_HV;
 
-    /*for (int k = 0; k < N_GRAM_SIZE; k++)
-    {
-        // Initializations
-        int quantized_features[DS_FEATURE_SIZE];
-        HV binded_feature[DS_FEATURE_SIZE];
-        HV temporal_HV[DS_FEATURE_SIZE];        
+    // 1) BIND the level vector with the base vector and bundle the result
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        HV level_hv = item_memory.level(quantized_features[i]);
+        HV base_hv = item_memory.base(i);
+        Encoded_HV = this->bundle(Encoded_HV, this->bind(level_hv, base_hv));
+    }
 
-        // 1) Compute the quantization level of each feature using get_quantized_level function
-        for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            quantized_features[i] = get_quantized_level(quantized_features[i][k], LevelList, HD_LV_LEN);
-            
-        // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
-        for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            binded_feature[i] = this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]);
+    // 2) Clip the HDC vector
+    return this->clip(Encoded_HV, DS_FEATURE_SIZE);
+}
+// --------------------End Procedural Encoding----------------------
 
-        // 3) Perform the temporal encoding by permuting each binded feature by the corresponding time index
-        for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            temporal_HV[i] = this->permutation(binded_feature[i], k);
+// --------------------Quantized Encoding----------------------
+// Same as encoding(), without the cycle count, for the uint8 levels of the quantizers
+HV HDC_op::encoding(const uint8_t quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN])
+{
+    BundledHV Encoded_HV;
+
+    // 1) BIND the level vector with the base vector and bundle the result
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        Encoded_HV = this->bundle(Encoded_HV, this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]));
+
+    // 2) Clip the HDC vector
+    return this->clip(Encoded_HV, DS_FEATURE_SIZE);
+}
+// --------------------End Quantized Encoding----------------------
+
+// --------------------Incremental Encoding----------------------
+EncoderState::EncoderState() {
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        quantized_features[i] = 0;
+    valid = 0;
+}
 
-        // 4) Bundle all the HV the HDC vector representation of the input feature vector
+// Stateful version of the spatial encoding for slowly changing inputs.
+// The bundled counters of the previous sample are kept in 'state'. For every feature whose level changed,
+// the old bound HV is subtracted from the counters and the new one is added. Since
+// bind(L_old, B_i) ^ bind(L_new, B_i) = L_old ^ L_new, only the bits in which the two level vectors differ
+// are touched, and only those bits are clipped again: the cost is O(changed * D) instead of O(F * D).
+// Input: quantized_features, BaseVectors, LevelVectors, state (updated in place)
+// Output: HDC vector, identical to the one returned by encoding()
+HV HDC_op::incremental_encoding(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], EncoderState& state)
+{
+    // 1) First sample: full encoding, keeping the bundled counters in the state
+    if (!state.valid) {
+        BundledHV Encoded_HV;
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            Encoded_HV = this->bundle(Encoded_HV, this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]));
+        state.Encoded_HV = Encoded_HV;
+        state.Clipped_HV = this->clip(Encoded_HV, DS_FEATURE_SIZE);
         for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            Encoded_HV = this->bundle(Encoded_HV, temporal_HV[i]);        
+            state.quantized_features[i] = quantized_features[i];
+        state.valid = 1;
+        return state.Clipped_HV;
     }
 
-    // 5) Clip the HDC vector
-    Clipped_HV = this->clip(Encoded_HV, DS_FEATURE_SIZE*N_GRAM_SIZE);*/
-    return Clipped_HV;
+    // 2) Following samples: update the counters only where the bound HV of a changed feature flips
+    int MAJORITY_THRESHOLD = DS_FEATURE_SIZE / 2;
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        int old_level = state.quantized_features[i];
+        int new_level = quantized_features[i];
+        if (old_level == new_level)
+            continue;
+
+        for (int j = 0; j < HV_CHUNKS; j++) {
+            uint32_t diff = (uint32_t)(LevelVectors[old_level].chunk[j] ^ LevelVectors[new_level].chunk[j]);
+            if (diff == 0)
+                continue;
+            uint32_t new_bound = (uint32_t)(LevelVectors[new_level].chunk[j] ^ BaseVectors[i].chunk[j]);
+            while (diff) {
+                int bit = __builtin_ctz(diff);
+                // 3) Subtract the old bound bit and add the new one: the counter moves by +/-1
+                int counter = state.Encoded_HV.get_counter(j, bit) + (((new_bound >> bit) & 1) ? 1 : -1);
+                state.Encoded_HV.set_counter(j, bit, counter);
+
+                // 4) Clip the affected bit only
+                if (counter > MAJORITY_THRESHOLD)
+                    state.Clipped_HV.chunk[j] |= (1u << bit);
+                else
+                    state.Clipped_HV.chunk[j] &= ~(1u << bit);
+                diff &= diff - 1;
+            }
+        }
+        state.quantized_features[i] = new_level;
+    }
+
+    #if DEBUG==1
+        printf("Incremental Encoded HV: ");
+        state.Clipped_HV.print();
+    #endif
+
+    return state.Clipped_HV;
 }
+// --------------------End Incremental Encoding----------------------
 
+// --------------------Bound Table Encoding----------------------
+BoundTable::BoundTable() {
+    valid = 0;
+}
 
-HV HDC_op::accl_temporal_encoding(int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE], int bv_start_addr, int lv_start_addr)
+// Precompute the F x L bound HVs once, so that the encoding becomes a gather followed by the bundling.
+// If the table does not fit in BOUND_TABLE_BUDGET it is left invalid and the encoders bind on the fly.
+void HDC_op::generate_BoundTable(HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], BoundTable& table)
 {
-    BundledHV Encoded_HV;
-    HV Clipped_HV;
-
-/*    for (int k = 0; k < N_GRAM_SIZE; k++)
-    { 
-        // 1) Compute the quantization level of each feature using get_quantized_level function
-        int quantized_features[DS_FEATURE_SIZE];
+    #if BOUND_TABLE_EN==1
         for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            quantized_features[i] = get_quantized_level(quantized_features[i][k], HD_LV_LEN);
+            for (int l = 0; l < HD_LV_LEN; l++)
+                table.bound[i * HD_LV_LEN + l] = this->bind(LevelVectors[l], BaseVectors[i]);
+        table.valid = 1;
+    #else
+        table.valid = 0;
+    #endif
+}
 
-        CSR_MVSIZE(HV_CHUNKS * 4);
-        // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
-        for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4));
+// Load the whole bound table in the SPM starting at table_start_addr (BOUND_TABLE_SIZE bytes).
+// The HVs are packed back to back (HV_CHUNKS words each) so that the table fits in a single SPM.
+void HDC_op::load_BoundTable(const BoundTable& table, int table_start_addr)
+{
+    #if BOUND_TABLE_EN==1
+        hvmemld((void*)((int*)table_start_addr), (void*)&table.bound[0].chunk[0], BOUND_TABLE_SIZE);
+    #endif
+}
 
-        // 3) Perform the temporal encoding by permuting each binded feature by the corresponding time index
-        for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            hvperm((void*)((int*)spmaddrC + i * HV_CHUNKS * 4), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4), (void*)k);
+// Spatial encoding reading the bound HVs from the precomputed table
+// Input: quantized_features, BaseVectors, LevelVectors (used only if the table is not valid), table
+// Output: HDC vector, identical to the one returned by encoding()
+HV HDC_op::table_encoding(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], const BoundTable& table)
+{
+    BundledHV Encoded_HV;
 
-        // 4) Bundle all the HV the HDC vector representation of the input feature vector
-        for (int i = 0; i < DS_FEATURE_SIZE; i++)
-            hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;
+    // 1) Gather the bound HVs and bundle them together
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        #if BOUND_TABLE_EN==1
+        if (table.valid) {
+            Encoded_HV = this->bundle(Encoded_HV, table.bound[i * HD_LV_LEN + quantized_features[i]]);
+            continue;
+        }
+        #endif
+        Encoded_HV = this->bundle(Encoded_HV, this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]));
     }
 
-    // 5) Clip the HDC vector
-    hvclip((void*)((int*)spmaddrC), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE*N_GRAM_SIZE));
-    hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));*/
-    return Clipped_HV;
+    // 2) Clip the HDC vector
+    return this->clip(Encoded_HV, DS_FEATURE_SIZE);
 }
-// --------------------End Temporal Encoding----------------------
 
-// --------------------Training----------------------
-BundledHV HDC_op::training(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], BundledHV ClassVectors[HD_CV_LEN], int class_label)
+// Accelerated table encoding: the bound HVs are gathered from the table loaded in SPM with load_BoundTable,
+// removing all the hvbind instructions. Without the table, bv_start_addr and lv_start_addr are bound on the fly.
+// As in accl_encoding, the bundling accumulator in spmaddrD must be zero.
+HV HDC_op::accl_table_encoding(int quantized_features[DS_FEATURE_SIZE], int table_start_addr, int bv_start_addr, int lv_start_addr)
 {
-    // We first encode the input feature vector into an HDC vector
-    //HV encoded_hv = this->encoding(quantized_features, BaseVectors, LevelVectors);
+    // Only the table or only the item memories are read, depending on BOUND_TABLE_EN
+    #if BOUND_TABLE_EN==1
+        (void)bv_start_addr;
+        (void)lv_start_addr;
+    #else
+        (void)table_start_addr;
+    #endif
+    CSR_MVSIZE(HV_CHUNKS * 4);
 
-    BundledHV Encoded_HV;
-    
-    start_count();
-    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
-    HV binded_feature[DS_FEATURE_SIZE];
-    for (int i = 0; i < DS_FEATURE_SIZE; i++)
-    {
-        binded_feature[i] = this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]);
-    }
-    
-    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        Encoded_HV = this->bundle(Encoded_HV, binded_feature[i]);
+    // 1) Gather the bound HVs and bundle them together
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        #if BOUND_TABLE_EN==1
+            hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)table_start_addr + (i * HD_LV_LEN + quantized_features[i]) * HV_CHUNKS));
+        #else
+            hvbind((void*)((int*)spmaddrC), (void*)((int*)lv_start_addr + quantized_features[i] * HV_CHUNKS * 4), (void*)((int*)bv_start_addr + i * HV_CHUNKS * 4));
+            hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC));
+        #endif
     }
 
-    // 4) Clip the HDC vector
+    // 2) Clip the HDC vector
     HV Clipped_HV;
-    Clipped_HV = this->clip(Encoded_HV,DS_FEATURE_SIZE);
-
-    // We can now bundle the HDC vector with the corresponding class vector
-    ClassVectors[class_label] = this->bundle(ClassVectors[class_label], Clipped_HV);
-    int std_cycle = finish_count();
-    printf("Standard Execution: %d cycles\n", std_cycle);
+    hvclip((void*)((int*)spmaddrC), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
+    hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));
 
-    return ClassVectors[class_label];
+    return Clipped_HV;
 }
+// --------------------End Bound Table Encoding----------------------
 
-BundledHV HDC_op::accl_training(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr, BundledHV ClassVectors[HD_CV_LEN], int class_label)
+// --------------------Positional Encoding----------------------
+// Spatial encoding without stored base vectors: the key of feature i is rho^i(seed), obtained from the key
+// of feature i-1 with a single permutation while streaming over the features. The item memory is O(D).
+// Input: quantized_features, SeedVector, LevelVectors
+// Output: HDC vector
+HV HDC_op::positional_encoding(int quantized_features[DS_FEATURE_SIZE], HV SeedVector, HV LevelVectors[HD_LV_LEN])
 {
-    
-    // We first encode the input feature vector into an HDC vector
-    // this->accl_encoding(quantized_features, bv_start_addr, lv_start_addr);   // Note: at the end of encoding, the HDC vector is stored in _spmC if the last flag is set to 0
-
     BundledHV Encoded_HV;
-    start_count();
-    CSR_MVSIZE(HV_CHUNKS * 4);
+    HV key = SeedVector;
 
-    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4));
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        // 1) BIND the level vector with the positional key of the feature
+        Encoded_HV = this->bundle(Encoded_HV, this->bind(LevelVectors[quantized_features[i]], key));
+
+        // 2) Next key: rho^(i+1)(seed) = rho(rho^i(seed))
+        key = this->permutation(key, 1);
     }
-    
-    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;
+
+    // 3) Clip the HDC vector
+    return this->clip(Encoded_HV, DS_FEATURE_SIZE);
+}
+
+// Accelerated positional encoding: the seed HV is stored at seed_addr and the keys are generated with hvperm
+// in the two following slots, used alternately, so the seed is preserved for the next samples.
+// As in accl_encoding, the bundling accumulator in spmaddrD must be zero.
+HV HDC_op::accl_positional_encoding(int quantized_features[DS_FEATURE_SIZE], int seed_addr, int lv_start_addr)
+{
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    int key_addr = seed_addr;
+
+    for (int i = 0; i < DS_FEATURE_SIZE; i++) {
+        // 1) Next key: rho^i(seed) from rho^(i-1)(seed)
+        if (i > 0) {
+            int next_key_addr = seed_addr + (1 + (i & 1)) * HV_CHUNKS * 4 * (int)sizeof(int);
+            hvperm((void*)((int*)next_key_addr), (void*)((int*)key_addr), (void*)1);
+            key_addr = next_key_addr;
+        }
+
+        // 2) BIND the level vector with the key and bundle the result
+        hvbind((void*)((int*)spmaddrC), (void*)((int*)lv_start_addr + quantized_features[i] * HV_CHUNKS * 4), (void*)((int*)key_addr));
+        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC));
     }
 
-    // 4) Clip the HDC vector
+    // 3) Clip the HDC vector
     HV Clipped_HV;
     hvclip((void*)((int*)spmaddrC), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
-    //hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));
+    hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));
 
-    int offset = class_label*HV_CHUNKS * 4;
-    // We can now bundle the HDC vector with the corresponding class vector using the hvbundle instruction
-    hvbundle((void*)((int*)spmaddrD+offset), (void*)((int*)spmaddrD+offset), (void*)((int*)spmaddrC)) ;
-    hvmemstr(&ClassVectors[class_label].bundled_chunk[0], (void*)((int*)spmaddrD+offset), sizeof(ClassVectors[class_label]));
-    int accl_cycle = finish_count();
-    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+    return Clipped_HV;
+}
+// --------------------End Positional Encoding----------------------
 
-    return ClassVectors[class_label];
+// --------------------Random Projection Encoding----------------------
+// Dense continuous features are encoded without quantization as sign(W * x), where W is a HV_SIZE_BIT x DS_FEATURE_SIZE
+// matrix of +1/-1. W is never stored: column f is the HV whose word w is hv_hash(seed, f, w), a 1 bit meaning +1.
+// Since W * x = 2 * (sum of the x_f with a 1 bit) - sum(x), only the positive partial sums are accumulated.
+// The features must be zero centered. Output bit d is 1 when (W * x)_d > 0.
+
+// Column words of the projection matrix use streams disjoint from the procedural item memory
+#define PROJECTION_STREAM(feature) (0x40000000u + (uint32_t)(feature))
+
+HV HDC_op::projection_encoding(const float FeatureVector[DS_FEATURE_SIZE], uint32_t seed)
+{
+    float positive[HV_SIZE_BIT];
+    float total = 0;
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        positive[d] = 0;
+
+    // 1) Accumulate the features on the rows where their column of W is +1
+    for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+        float x = FeatureVector[f];
+        total += x;
+        for (int w = 0; w < HV_CHUNKS; w++) {
+            uint32_t column = hv_hash(seed, PROJECTION_STREAM(f), w);
+            float* row = &positive[w * 32];
+            for (int b = 0; b < 32; b++)
+                if ((column >> b) & 1)
+                    row[b] += x;
+        }
+    }
+
+    // 2) Sign of the projection
+    HV Projected_HV;
+    for (int w = 0; w < HV_CHUNKS; w++)
+        for (int b = 0; b < 32; b++)
+            if (2 * positive[w * 32 + b] > total)
+                Projected_HV.chunk[w] |= (1u << b);
+    return Projected_HV;
 }
-// --------------------End Training----------------------
 
-// --------------------Inference----------------------
-int HDC_op::inference(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], HV ClassVectors[HD_CV_LEN])
+HV HDC_op::projection_encoding(const int8_t FeatureVector[DS_FEATURE_SIZE], uint32_t seed)
 {
-    //HV encoded_hv = this->encoding(quantized_features, BaseVectors, LevelVectors);
-    // Encoding
-    
+    HV Projected_HV;
+    this->projection_encoding_batch((const int8_t (*)[DS_FEATURE_SIZE])FeatureVector, 1, &Projected_HV, seed);
+    return Projected_HV;
+}
 
-    BundledHV Encoded_HV;
-    start_count();    
-    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
-    HV binded_feature[DS_FEATURE_SIZE];
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        binded_feature[i] = this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]);
-    }
-    
-    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        Encoded_HV = this->bundle(Encoded_HV, binded_feature[i]);
-    }
+// Batched version: blocks of PROJECTION_BATCH samples and PROJECTION_BLOCK chunks. Each word of W is generated
+// once per block and applied to all the samples of the block, and the integer accumulators of a block
+// (PROJECTION_BATCH x PROJECTION_BLOCK x 32) stay in cache. The 0/x selection is branch free.
+void HDC_op::projection_encoding_batch(const int8_t FeatureMatrix[][DS_FEATURE_SIZE], int samples, HV EncodedHVs[], uint32_t seed)
+{
+    int positive[PROJECTION_BATCH][PROJECTION_BLOCK * 32];
 
-    // 4) Clip the HDC vector
-    HV Clipped_HV;
-    Clipped_HV = this->clip(Encoded_HV,DS_FEATURE_SIZE);
+    for (int first = 0; first < samples; first += PROJECTION_BATCH) {
+        int batch = samples - first < PROJECTION_BATCH ? samples - first : PROJECTION_BATCH;
 
-    int minimum_distance = HV_SIZE_BIT;
-    int predicted_class = -1;
-    for (int i = 0; i < HD_CV_LEN; i++){
-        int hamming_distance = this->similarity(Clipped_HV, ClassVectors[i]);
-        if (hamming_distance < minimum_distance)
-        {
-            minimum_distance = hamming_distance;
-            predicted_class = i;
+        int total[PROJECTION_BATCH];
+        for (int s = 0; s < batch; s++) {
+            total[s] = 0;
+            for (int f = 0; f < DS_FEATURE_SIZE; f++)
+                total[s] += FeatureMatrix[first + s][f];
+            EncodedHVs[first + s] = HV();
+        }
+
+        for (int block = 0; block < HV_CHUNKS; block += PROJECTION_BLOCK) {
+            int words = HV_CHUNKS - block < PROJECTION_BLOCK ? HV_CHUNKS - block : PROJECTION_BLOCK;
+            for (int s = 0; s < batch; s++)
+                for (int d = 0; d < words * 32; d++)
+                    positive[s][d] = 0;
+
+            // 1) Accumulate the features on the rows where their column of W is +1
+            for (int f = 0; f < DS_FEATURE_SIZE; f++) {
+                for (int w = 0; w < words; w++) {
+                    uint32_t column = hv_hash(seed, PROJECTION_STREAM(f), block + w);
+                    for (int s = 0; s < batch; s++) {
+                        int x = FeatureMatrix[first + s][f];
+                        int* row = &positive[s][w * 32];
+                        for (int b = 0; b < 32; b++)
+                            row[b] += x & -(int)((column >> b) & 1);
+                    }
+                }
+            }
+
+            // 2) Sign of the projection
+            for (int s = 0; s < batch; s++) {
+                for (int w = 0; w < words; w++) {
+                    uint32_t bits = 0;
+                    for (int b = 0; b < 32; b++)
+                        bits |= (uint32_t)(2 * positive[s][w * 32 + b] > total[s]) << b;
+                    EncodedHVs[first + s].chunk[block + w] = (int)bits;
+                }
+            }
         }
     }
+}
+// --------------------End Random Projection Encoding----------------------
 
-    int std_cycle = finish_count();
-    printf("Standard Execution: %d cycles\n", std_cycle);
+// --------------------Temporal Encoding----------------------
+// N-gram of the spatial HVs S_k of N_GRAM_SIZE consecutive time steps:
+// G = rho^(N-1)(S_0) ^ rho^(N-2)(S_1) ^ ... ^ S_(N-1)
+// Each time step permutes the running product by one position and binds the new spatial HV.
+// In the streaming versions the product is updated in place: the expired element rho^N(S_(t-N)) is
+// unbound from rho(G), so each new time step costs one spatial encoding instead of N_GRAM_SIZE.
+
+// SPM slots of the accelerated temporal encoding in spmaddrC, after the DS_FEATURE_SIZE bound features
+#define TEMPORAL_SLOT(slot) ((void*)((int*)spmaddrC + (DS_FEATURE_SIZE + (slot)) * HV_CHUNKS * 4))
+#define TEMPORAL_S      0   // Spatial HV of the batch encoding
+#define TEMPORAL_G      1   // Running N-gram
+#define TEMPORAL_P      2   // rho(G)
+#define TEMPORAL_E      3   // Expired element rho^N(S_(t-N))
+#define TEMPORAL_T      4   // rho(G) with the expired element unbound
+#define TEMPORAL_W      5   // First slot of the window of the streaming encoding
+
+NGramState::NGramState() {
+    head = 0;
+    count = 0;
+}
 
+// Add an input to the rolling N-gram: G_t = rho(G_(t-1)) ^ x_t ^ rho^N(x_(t-N))
+HV HDC_op::ngram_update(NGramState& state, const HV& input)
+{
+    HV rotated = this->permutation(state.ngram, 1);
 
-    return predicted_class;
+    // Unbind the element leaving the window: binding is its own inverse
+    if (state.count == N_GRAM_SIZE)
+        rotated = this->bind(rotated, this->positional_key(state.window[state.head], N_GRAM_SIZE));
+
+    state.ngram = this->bind(rotated, input);
+    state.window[state.head] = input;
+    state.head = (state.head + 1) % N_GRAM_SIZE;
+    if (state.count < N_GRAM_SIZE)
+        state.count++;
+
+    return state.ngram;
 }
 
-int HDC_op::accl_inference(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr, HV ClassVectors[HD_CV_LEN])
+// Input: quantized_features[i][k] is the level of feature i at time step k, BaseVectors, LevelVectors
+// Output: N-gram HV
+HV HDC_op::temporal_encoding(int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN])
 {
-    int minimum_distance = HV_SIZE_BIT;
-    int predicted_class = -1;
-    int hamming_distance;
-    
-    // We first encode the input feature vector into an HDC vector
-    //this->accl_encoding(quantized_features, bv_start_addr, lv_start_addr);   // Note: at the end of encoding, the HDC vector is stored in _spmC if the last flag is set to 0
+    HV NGram_HV;
 
-    BundledHV Encoded_HV;
+    for (int k = 0; k < N_GRAM_SIZE; k++)
+    {
+        // 1) BIND the level vector of each feature at time k with its base vector and bundle them
+        BundledHV Encoded_HV;
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            Encoded_HV = this->bundle(Encoded_HV, this->bind(LevelVectors[quantized_features[i][k]], BaseVectors[i]));
 
-    start_count();
-    CSR_MVSIZE(HV_CHUNKS * 4);
-    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4)); 
-    }
-    
-    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
-    for (int i = 0; i < DS_FEATURE_SIZE; i++){
-        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;  
+        // 2) Clip to obtain the spatial HV of time k
+        HV Spatial_HV = this->clip(Encoded_HV, DS_FEATURE_SIZE);
+
+        // 3) Permute the previous time steps by one position and bind the new one
+        NGram_HV = this->bind(this->permutation(NGram_HV, 1), Spatial_HV);
     }
 
-    // 4) Clip the HDC vector
-    HV Clipped_HV;
-    hvclip((void*)((int*)spmaddrC), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
-    // hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));
+    return NGram_HV;
+}
 
-    int class_offset = HV_CHUNKS*4*2;
-    
-    for (int i = 0; i < HD_CV_LEN; i++){
-        hvsim((void*)((int*)spmaddrC+HV_CHUNKS * 4), (void*)((int*)spmaddrD + class_offset + i*HV_CHUNKS * 4), (void*)((int*)spmaddrC)) ;
-        hvmemstr(&hamming_distance, (void*)((int*)spmaddrC+HV_CHUNKS * 4), sizeof(int));
-        if (hamming_distance < minimum_distance)
-        {
-            minimum_distance = hamming_distance;
-            predicted_class = i;
-        }
+
+HV HDC_op::accl_temporal_encoding(int quantized_features[DS_FEATURE_SIZE][N_GRAM_SIZE], int bv_start_addr, int lv_start_addr)
+{
+    HV NGram_HV;
+    BundledHV zero_HV;
+
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    hvmemld(TEMPORAL_SLOT(TEMPORAL_G), &NGram_HV.chunk[0], sizeof(NGram_HV));
+
+    for (int k = 0; k < N_GRAM_SIZE; k++)
+    { 
+        // 1) BIND the level vector of each feature at time k with its base vector and bundle them
+        hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i][k]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4));
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;
+
+        // 2) Clip to obtain the spatial HV of time k
+        hvclip(TEMPORAL_SLOT(TEMPORAL_S), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
+
+        // 3) Permute the previous time steps by one position and bind the new one
+        hvperm(TEMPORAL_SLOT(TEMPORAL_P), TEMPORAL_SLOT(TEMPORAL_G), (void*)1);
+        hvbind(TEMPORAL_SLOT(TEMPORAL_G), TEMPORAL_SLOT(TEMPORAL_P), TEMPORAL_SLOT(TEMPORAL_S));
     }
 
-    int accl_cycle = finish_count();
-    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+    hvmemstr(&NGram_HV.chunk[0], TEMPORAL_SLOT(TEMPORAL_G), sizeof(NGram_HV));
+    return NGram_HV;
+}
+
+// Streaming temporal encoding: encodes one time step and updates the rolling N-gram in the state.
+// The returned HV is the N-gram of the last N_GRAM_SIZE steps once state.count == N_GRAM_SIZE.
+HV HDC_op::temporal_encoding_step(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], NGramState& state)
+{
+    // 1) Spatial HV of the new time step
+    BundledHV Encoded_HV;
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        Encoded_HV = this->bundle(Encoded_HV, this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]));
+    HV Spatial_HV = this->clip(Encoded_HV, DS_FEATURE_SIZE);
 
+    // 2) Rolling N-gram update
+    return this->ngram_update(state, Spatial_HV);
+}
+
+// Accelerated streaming temporal encoding: the running N-gram and the window of spatial HVs stay in spmaddrC
+// between the calls, only head and count of the state are used. state.ngram receives a copy of the N-gram.
+HV HDC_op::accl_temporal_encoding_step(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr, NGramState& state)
+{
+    BundledHV zero_HV;
+    void* window_slot = TEMPORAL_SLOT(TEMPORAL_W + state.head);
+
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    if (state.count == 0)
+        hvmemld(TEMPORAL_SLOT(TEMPORAL_G), &zero_HV.bundled_chunk[0], HV_CHUNKS * 4);
+
+    // 1) Expired element, before its slot is overwritten by the new spatial HV
+    if (state.count == N_GRAM_SIZE)
+        hvperm(TEMPORAL_SLOT(TEMPORAL_E), window_slot, (void*)N_GRAM_SIZE);
+
+    // 2) Spatial HV of the new time step, clipped directly in the window
+    hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4));
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;
+    hvclip(window_slot, (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
+
+    // 3) Rolling N-gram update: G = rho(G) ^ rho^N(S_(t-N)) ^ S_t
+    hvperm(TEMPORAL_SLOT(TEMPORAL_P), TEMPORAL_SLOT(TEMPORAL_G), (void*)1);
+    if (state.count == N_GRAM_SIZE) {
+        hvbind(TEMPORAL_SLOT(TEMPORAL_T), TEMPORAL_SLOT(TEMPORAL_P), TEMPORAL_SLOT(TEMPORAL_E));
+        hvbind(TEMPORAL_SLOT(TEMPORAL_G), TEMPORAL_SLOT(TEMPORAL_T), window_slot);
+    } else {
+        hvbind(TEMPORAL_SLOT(TEMPORAL_G), TEMPORAL_SLOT(TEMPORAL_P), window_slot);
+        state.count++;
+    }
+    state.head = (state.head + 1) % N_GRAM_SIZE;
+
+    hvmemstr(&state.ngram.chunk[0], TEMPORAL_SLOT(TEMPORAL_G), sizeof(state.ngram));
+    return state.ngram;
+}
+// --------------------End Temporal Encoding----------------------
+
+// --------------------Text Encoding----------------------
+// Each character is mapped to the HV of its symbol, the symbols go through the rolling N-gram
+// (see ngram_update) and every complete N-gram is bundled in the integer counters of the state.
+// The accelerated version bundles in the 4-bit counters of spmaddrD and moves them to the state
+// every 15 N-grams, before they wrap.
+
+// SPM layout of the accelerated text encoding. The symbol HVs are packed (HV_CHUNKS ints each) so that
+// the table and its permuted copy fit in a single SPM, the work slots use the usual stride in spmaddrC.
+#define TEXT_SYMBOL(addr, symbol)  ((void*)((int*)(addr) + (symbol) * HV_CHUNKS))
+#define TEXT_EXPIRED(addr, symbol) ((void*)((int*)(addr) + (TEXT_ALPHABET + (symbol)) * HV_CHUNKS))
+#define TEXT_SLOT(slot) ((void*)((int*)spmaddrC + (slot) * HV_CHUNKS * 4))
+#define TEXT_G  0   // Running N-gram
+#define TEXT_P  1   // rho(G)
+#define TEXT_T  2   // rho(G) with the expired symbol unbound
+#define TEXT_FLUSH ((1 << COUNTER_BITS) - 1)
+
+TextState::TextState() {
+    for (int i = 0; i < N_GRAM_SIZE; i++)
+        symbols[i] = 0;
+    for (int i = 0; i < HV_SIZE_BIT; i++)
+        counters[i] = 0;
+    ngrams = 0;
+}
+
+int text_symbol(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        return c - 'a';
+    if (c >= 'A' && c <= 'Z')
+        return c - 'A';
+    return TEXT_ALPHABET - 1;
+}
+
+void HDC_op::generate_SymbolHVs(HV SymbolVectors[TEXT_ALPHABET])
+{
+    for (int s = 0; s < TEXT_ALPHABET; s++)
+        SymbolVectors[s].randomize(rng);
+}
+
+// The permuted copy holds rho^N(symbol), the term unbound when the symbol leaves the window
+void HDC_op::load_SymbolHVs(HV SymbolVectors[TEXT_ALPHABET], int symbol_start_addr)
+{
+    for (int s = 0; s < TEXT_ALPHABET; s++) {
+        HV expired = this->positional_key(SymbolVectors[s], N_GRAM_SIZE);
+        hvmemld(TEXT_SYMBOL(symbol_start_addr, s), &SymbolVectors[s].chunk[0], HV_CHUNKS * 4);
+        hvmemld(TEXT_EXPIRED(symbol_start_addr, s), &expired.chunk[0], HV_CHUNKS * 4);
+    }
+}
+
+void HDC_op::text_encoding(const char* text, int length, HV SymbolVectors[TEXT_ALPHABET], TextState& state)
+{
+    for (int n = 0; n < length; n++) {
+        // 1) Rolling N-gram update with the symbol of the new character
+        HV NGram_HV = this->ngram_update(state.ngram, SymbolVectors[text_symbol(text[n])]);
+        if (state.ngram.count < N_GRAM_SIZE)
+            continue;
+
+        // 2) Bundle the complete N-gram
+        for (int c = 0; c < HV_CHUNKS; c++) {
+            uint32_t bits = NGram_HV.chunk[c];
+            int* counter = &state.counters[c * 32];
+            for (int b = 0; b < 32; b++)
+                counter[b] += (bits >> b) & 1;
+        }
+        state.ngrams++;
+    }
+}
+
+// Move the 4-bit counters of spmaddrD to the state and reset them
+static void text_flush(TextState& state)
+{
+    BundledHV bundled, zero_HV;
+    hvmemstr(&bundled.bundled_chunk[0], (void*)((int*)spmaddrD), sizeof(bundled));
+    for (int c = 0; c < HV_CHUNKS; c++)
+        for (int b = 0; b < 32; b++)
+            state.counters[c * 32 + b] += bundled.get_counter(c, b);
+    hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
+}
+
+// The symbols must have been stored with load_SymbolHVs. The running N-gram stays in spmaddrC
+// between the calls, and the counters are up to date in the state when the call returns.
+void HDC_op::accl_text_encoding(const char* text, int length, int symbol_start_addr, TextState& state)
+{
+    BundledHV zero_HV;
+    int pending = 0;
+
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    hvmemld((void*)((int*)spmaddrD), &zero_HV.bundled_chunk[0], sizeof(zero_HV));
+    if (state.ngram.count == 0)
+        hvmemld(TEXT_SLOT(TEXT_G), &zero_HV.bundled_chunk[0], HV_CHUNKS * 4);
+
+    for (int n = 0; n < length; n++) {
+        int symbol = text_symbol(text[n]);
+
+        // 1) Rolling N-gram update: G = rho(G) ^ rho^N(x_(t-N)) ^ x_t
+        hvperm(TEXT_SLOT(TEXT_P), TEXT_SLOT(TEXT_G), (void*)1);
+        if (state.ngram.count == N_GRAM_SIZE) {
+            hvbind(TEXT_SLOT(TEXT_T), TEXT_SLOT(TEXT_P), TEXT_EXPIRED(symbol_start_addr, state.symbols[state.ngram.head]));
+            hvbind(TEXT_SLOT(TEXT_G), TEXT_SLOT(TEXT_T), TEXT_SYMBOL(symbol_start_addr, symbol));
+        } else {
+            hvbind(TEXT_SLOT(TEXT_G), TEXT_SLOT(TEXT_P), TEXT_SYMBOL(symbol_start_addr, symbol));
+            state.ngram.count++;
+        }
+        state.symbols[state.ngram.head] = symbol;
+        state.ngram.head = (state.ngram.head + 1) % N_GRAM_SIZE;
+        if (state.ngram.count < N_GRAM_SIZE)
+            continue;
+
+        // 2) Bundle the complete N-gram, the counters are flushed before they wrap
+        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), TEXT_SLOT(TEXT_G));
+        state.ngrams++;
+        if (++pending == TEXT_FLUSH) {
+            text_flush(state);
+            pending = 0;
+        }
+    }
+
+    if (pending != 0)
+        text_flush(state);
+    hvmemstr(&state.ngram.ngram.chunk[0], TEXT_SLOT(TEXT_G), sizeof(state.ngram.ngram));
+}
+
+HV HDC_op::text_clip(const TextState& state)
+{
+    int MAJORITY_THRESHOLD = state.ngrams / 2;
+    HV Text_HV;
+    for (int c = 0; c < HV_CHUNKS; c++)
+        for (int b = 0; b < 32; b++)
+            if (state.counters[c * 32 + b] > MAJORITY_THRESHOLD)
+                Text_HV.chunk[c] |= (1u << b);
+    return Text_HV;
+}
+// --------------------End Text Encoding----------------------
+
+// --------------------Image Encoding----------------------
+// Pixel (r, c) with intensity level l contributes rho^r(R) ^ rho^c(C) ^ LevelVectors[l], and the
+// IMAGE_HEIGHT * IMAGE_WIDTH pixel HVs are bundled in bit-sliced counters, which do not wrap like
+// the 4-bit ones. For each row the key is bound once with every level, so each pixel costs a
+// single bind with its cached column key. Images of 2^SLICED_PLANES pixels or more would wrap the
+// bit-sliced counters: their rows are folded in integer counters every IMAGE_FOLD_ROWS rows.
+
+#if IMAGE_WIDTH >= (1 << SLICED_PLANES)
+#error "IMAGE_WIDTH must be below 2^SLICED_PLANES: one row is bundled in the bit-sliced counters"
+#endif
+
+// Rows bundled in the bit-sliced counters before they are folded in the integer counters
+#define IMAGE_FOLD_ROWS (((1 << SLICED_PLANES) - 1) / IMAGE_WIDTH)
+
+// Majority of bit-sliced counters, same threshold as clip()
+HV HDC_op::clip(const SlicedHV& sliced_hv, int HV_BUNDLED)
+{
+    return sliced_hv.threshold(HV_BUNDLED / 2);
+}
+
+void HDC_op::generate_ImageKeys(ImageKeys& keys)
+{
+    HV column_seed;
+    keys.row_seed.randomize(rng);
+    column_seed.randomize(rng);
+    for (int c = 0; c < IMAGE_WIDTH; c++)
+        keys.column[c] = this->positional_key(column_seed, c);
+}
+
+HV HDC_op::image_encoding(const uint8_t image[IMAGE_HEIGHT * IMAGE_WIDTH], const ImageKeys& keys, HV LevelVectors[HD_LV_LEN])
+{
+    HV Encoded_HV;
+    this->image_encoding_batch((const uint8_t (*)[IMAGE_HEIGHT * IMAGE_WIDTH])image, 1, keys, LevelVectors, &Encoded_HV);
+    return Encoded_HV;
+}
+
+#if IMAGE_FOLD_ROWS < IMAGE_HEIGHT
+// Add the bit-sliced counters to the integer ones and clear them
+static void image_fold(int counters[HV_SIZE_BIT], SlicedHV& accumulator)
+{
+    for (int p = 0; p < SLICED_PLANES; p++)
+        for (int c = 0; c < HV_CHUNKS; c++) {
+            uint32_t bits = accumulator.plane[p][c];
+            for (int b = 0; b < 32; b++)
+                counters[c * 32 + b] += ((bits >> b) & 1) << p;
+        }
+    accumulator = SlicedHV();
+}
+#endif
+
+// The images are encoded IMAGE_BATCH at a time, so that each row key and its level bindings are
+// computed once per batch instead of once per image
+void HDC_op::image_encoding_batch(const uint8_t images[][IMAGE_HEIGHT * IMAGE_WIDTH], int count, const ImageKeys& keys, HV LevelVectors[HD_LV_LEN], HV EncodedHVs[])
+{
+    SlicedHV accumulator[IMAGE_BATCH];
+#if IMAGE_FOLD_ROWS < IMAGE_HEIGHT
+    static int counters[IMAGE_BATCH][HV_SIZE_BIT];
+#endif
+
+    for (int first = 0; first < count; first += IMAGE_BATCH) {
+        int batch = count - first < IMAGE_BATCH ? count - first : IMAGE_BATCH;
+        for (int i = 0; i < batch; i++) {
+            accumulator[i] = SlicedHV();
+#if IMAGE_FOLD_ROWS < IMAGE_HEIGHT
+            for (int d = 0; d < HV_SIZE_BIT; d++)
+                counters[i][d] = 0;
+#endif
+        }
+
+        HV row_key = keys.row_seed;
+        for (int r = 0; r < IMAGE_HEIGHT; r++) {
+            // 1) Row key bound with every level
+            HV row_level[HD_LV_LEN];
+            if (r != 0)
+                row_key = this->permutation(row_key, 1);
+            for (int l = 0; l < HD_LV_LEN; l++)
+                row_level[l] = this->bind(row_key, LevelVectors[l]);
+
+            // 2) Bind with the column key and bundle every pixel of the row
+            for (int i = 0; i < batch; i++) {
+                const uint8_t* pixel = &images[first + i][r * IMAGE_WIDTH];
+                for (int c = 0; c < IMAGE_WIDTH; c++) {
+                    const HV& level = row_level[(pixel[c] * HD_LV_LEN) >> 8];
+                    for (int j = 0; j < HV_CHUNKS; j++)
+                        accumulator[i].add_chunk(j, keys.column[c].chunk[j] ^ level.chunk[j]);
+                }
+#if IMAGE_FOLD_ROWS < IMAGE_HEIGHT
+                if ((r + 1) % IMAGE_FOLD_ROWS == 0 || r == IMAGE_HEIGHT - 1)
+                    image_fold(counters[i], accumulator[i]);
+#endif
+            }
+        }
+
+        // 3) Clip
+        for (int i = 0; i < batch; i++) {
+#if IMAGE_FOLD_ROWS < IMAGE_HEIGHT
+            HV Encoded_HV;
+            for (int c = 0; c < HV_CHUNKS; c++)
+                for (int b = 0; b < 32; b++)
+                    if (counters[i][c * 32 + b] > IMAGE_HEIGHT * IMAGE_WIDTH / 2)
+                        Encoded_HV.chunk[c] |= (1u << b);
+            EncodedHVs[first + i] = Encoded_HV;
+#else
+            EncodedHVs[first + i] = this->clip(accumulator[i], IMAGE_HEIGHT * IMAGE_WIDTH);
+#endif
+        }
+    }
+}
+// --------------------End Image Encoding----------------------
+
+// --------------------Graph Encoding----------------------
+// Edge u -> v is bind(rho(N_u), N_v) and a graph is the majority of its edges. The edges are bundled
+// GRAPH_BATCH at a time in bit-sliced counters, then merged in the integer counters of the state, so
+// the number of edges is only bounded by the int counters.
+
+GraphState::GraphState() {
+    for (int i = 0; i < HV_SIZE_BIT; i++)
+        counters[i] = 0;
+    edges = 0;
+}
+
+HV HDC_op::edge_hv(const HV& source, const HV& target)
+{
+    return this->bind(this->permutation(source, 1), target);
+}
+
+// Add the counters of a batch to the state
+static void graph_add(GraphState& state, const SlicedHV& batch)
+{
+    for (int p = 0; p < SLICED_PLANES; p++)
+        for (int c = 0; c < HV_CHUNKS; c++) {
+            uint32_t bits = batch.plane[p][c];
+            int* counter = &state.counters[c * 32];
+            for (int b = 0; b < 32; b++)
+                counter[b] += ((bits >> b) & 1) << p;
+        }
+    state.edges += batch.count;
+}
+
+void HDC_op::graph_encoding(const int edges[][2], int count, NodeMemory& nodes, GraphState& state)
+{
+    for (int first = 0; first < count; first += GRAPH_BATCH) {
+        int batch = count - first < GRAPH_BATCH ? count - first : GRAPH_BATCH;
+        SlicedHV Bundled_HV;
+        for (int e = first; e < first + batch; e++)
+            Bundled_HV.add(this->edge_hv(nodes.node(edges[e][0]), nodes.node(edges[e][1])));
+        graph_add(state, Bundled_HV);
+    }
+}
+
+void HDC_op::graph_encoding(const int edges[][2], int count, const HV NodeHVs[], GraphState& state)
+{
+    for (int first = 0; first < count; first += GRAPH_BATCH) {
+        int batch = count - first < GRAPH_BATCH ? count - first : GRAPH_BATCH;
+        SlicedHV Bundled_HV;
+        for (int e = first; e < first + batch; e++)
+            Bundled_HV.add(this->edge_hv(NodeHVs[edges[e][0]], NodeHVs[edges[e][1]]));
+        graph_add(state, Bundled_HV);
+    }
+}
+
+// One iteration: H_v = majority(H_v, rho(H_u) for every edge u -> v), all the nodes updated from the
+// previous iteration. Accumulators is a work array of num_nodes entries, in-degrees must stay below
+// 2^SLICED_PLANES - 1.
+void HDC_op::graph_aggregate(const int edges[][2], int count, int num_nodes, HV NodeHVs[], SlicedHV Accumulators[], int iterations)
+{
+    for (int k = 0; k < iterations; k++) {
+        for (int v = 0; v < num_nodes; v++) {
+            Accumulators[v] = SlicedHV();
+            Accumulators[v].add(NodeHVs[v]);
+        }
+        for (int e = 0; e < count; e++)
+            Accumulators[edges[e][1]].add(this->permutation(NodeHVs[edges[e][0]], 1));
+        for (int v = 0; v < num_nodes; v++)
+            NodeHVs[v] = this->clip(Accumulators[v], Accumulators[v].count);
+    }
+}
+
+void HDC_op::graph_merge(GraphState& state, const GraphState& partition)
+{
+    for (int i = 0; i < HV_SIZE_BIT; i++)
+        state.counters[i] += partition.counters[i];
+    state.edges += partition.edges;
+}
+
+HV HDC_op::graph_clip(const GraphState& state)
+{
+    int MAJORITY_THRESHOLD = state.edges / 2;
+    HV Graph_HV;
+    for (int c = 0; c < HV_CHUNKS; c++)
+        for (int b = 0; b < 32; b++)
+            if (state.counters[c * 32 + b] > MAJORITY_THRESHOLD)
+                Graph_HV.chunk[c] |= (1u << b);
+    return Graph_HV;
+}
+// --------------------End Graph Encoding----------------------
+
+// --------------------Record Memory----------------------
+// A record is the majority of its key x value pairs. Unbinding it with a key gives a noisy copy of the
+// value, which is cleaned up with the nearest entry of the value codebook. The cleanup search stops
+// accumulating the distance to an entry as soon as it reaches the best distance found so far.
+
+HV HDC_op::record_encoding(const HV Keys[], const HV Values[], int pairs)
+{
+    SlicedHV Bundled_HV;
+    for (int i = 0; i < pairs; i++)
+        Bundled_HV.add(this->bind(Keys[i], Values[i]));
+
+    // An even number of pairs is completed with the bind of the first two pairs, to break the ties
+    if (pairs % 2 == 0 && pairs > 0)
+        Bundled_HV.add(this->bind(this->bind(Keys[0], Values[0]), this->bind(Keys[1 % pairs], Values[1 % pairs])));
+
+    return this->clip(Bundled_HV, Bundled_HV.count);
+}
+
+int HDC_op::cleanup(const HV& query, const HV Codebook[], int size, int chunks)
+{
+    int bestDistance = chunks * 32 + 1;
+    int bestIndex = 0;
+
+    for (int j = 0; j < size; j++) {
+        int hammingDistance = 0;
+        for (int i = 0; i < chunks && hammingDistance < bestDistance; i++)
+            hammingDistance += __builtin_popcount((uint32_t)(query.chunk[i] ^ Codebook[j].chunk[i]));
+        if (hammingDistance < bestDistance) {
+            bestDistance = hammingDistance;
+            bestIndex = j;
+        }
+    }
+    return bestIndex;
+}
+
+int HDC_op::record_query(const HV& record, const HV& key, const HV Codebook[], int size)
+{
+    return this->cleanup(this->bind(record, key), Codebook, size, HV_CHUNKS);
+}
+
+// The codebook is scanned once for all the queries, each entry compared with every unbound query
+// while it is in cache. Results must have room for 'queries' entries.
+void HDC_op::record_query_batch(const HV& record, const HV Keys[], int queries, const HV Codebook[], int size, int Results[])
+{
+    for (int first = 0; first < queries; first += RECORD_QUERY_BATCH) {
+        int batch = queries - first < RECORD_QUERY_BATCH ? queries - first : RECORD_QUERY_BATCH;
+        HV Unbound_HV[RECORD_QUERY_BATCH];
+        int bestDistance[RECORD_QUERY_BATCH];
+        for (int q = 0; q < batch; q++) {
+            Unbound_HV[q] = this->bind(record, Keys[first + q]);
+            bestDistance[q] = HV_SIZE_BIT + 1;
+            Results[first + q] = 0;
+        }
+
+        for (int j = 0; j < size; j++) {
+            for (int q = 0; q < batch; q++) {
+                int hammingDistance = 0;
+                for (int i = 0; i < HV_CHUNKS && hammingDistance < bestDistance[q]; i++)
+                    hammingDistance += __builtin_popcount((uint32_t)(Unbound_HV[q].chunk[i] ^ Codebook[j].chunk[i]));
+                if (hammingDistance < bestDistance[q]) {
+                    bestDistance[q] = hammingDistance;
+                    Results[first + q] = j;
+                }
+            }
+        }
+    }
+}
+
+// 1) Unbind with hvbind in spmaddrC, 2) cleanup of the whole codebook with a single hvsearch (kdotp)
+int HDC_op::accl_record_query(int record_addr, int key_addr, int codebook_addr, int size)
+{
+    int bestIndex;
+
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    CSR_MPSCLFAC(size);
+    hvbind((void*)((int*)spmaddrC + HV_CHUNKS * 4), (void*)((int*)record_addr), (void*)((int*)key_addr));
+    kdotp((void*)((int*)spmaddrC), (void*)((int*)spmaddrC + HV_CHUNKS * 4), (void*)((int*)codebook_addr));
+    hvmemstr(&bestIndex, (void*)((int*)spmaddrC), sizeof(int));
+
+    return bestIndex;
+}
+// --------------------End Record Memory----------------------
+
+// --------------------Resonator Network----------------------
+// The product s = x1 ^ x2 ^ ... ^ xF of one entry per codebook is factorized iteratively instead of
+// trying all the RESONATOR_CODEBOOK^F combinations. Each factor estimate is replaced in turn by the
+// projection of s ^ (the other estimates) on its codebook: in bipolar terms sign(sum_i a_i X_i), with
+// a_i = D - 2 * hamming(X_i, u) the bipolar dot product. The estimates start from the superposition of
+// their codebook and the network has converged when a whole iteration leaves them unchanged.
+// A fixed point whose factors do not rebuild the product is spurious: the network restarts from
+// random estimates, within the same RESONATOR_MAX_ITER iterations.
+
+// SPM slots of the accelerated resonator in spmaddrC: the RESONATOR_FACTORS estimates, then the work slots
+#define RESONATOR_SLOT(slot) ((void*)((int*)spmaddrC + (slot) * HV_CHUNKS * 4))
+#define RESONATOR_U     (RESONATOR_FACTORS)        // Product unbound from the other estimates
+#define RESONATOR_DIST  (RESONATOR_FACTORS + 1)    // Output of hvsim
+#define RESONATOR_SEED  0x5EED                     // Seed of the tie breaks and of the restarts
+
+// Weighted projection on a codebook: bit d of the estimate is 1 where the entries with the bit set
+// have more than half of the total weight (bit 1 is -1 in bipolar terms), ties keep the previous bit.
+// Returns 1 if the estimate changed.
+static int resonator_project(const int weights[RESONATOR_CODEBOOK], const HV Codebook[RESONATOR_CODEBOOK], HV& estimate)
+{
+    int total = 0;
+    int positive[HV_SIZE_BIT];
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        positive[d] = 0;
+    for (int i = 0; i < RESONATOR_CODEBOOK; i++) {
+        total += weights[i];
+        for (int c = 0; c < HV_CHUNKS; c++) {
+            uint32_t bits = Codebook[i].chunk[c];
+            int* row = &positive[c * 32];
+            for (int b = 0; b < 32; b++)
+                row[b] += weights[i] & -(int)((bits >> b) & 1);
+        }
+    }
+
+    int changed = 0;
+    for (int c = 0; c < HV_CHUNKS; c++) {
+        uint32_t bits = 0;
+        for (int b = 0; b < 32; b++) {
+            int twice = 2 * positive[c * 32 + b];
+            bits |= (uint32_t)(twice > total || (twice == total && ((estimate.chunk[c] >> b) & 1))) << b;
+        }
+        changed |= (estimate.chunk[c] != (int)bits);
+        estimate.chunk[c] = bits;
+    }
+    return changed;
+}
+
+// Initial estimates: superposition of the codebooks on the first attempt, random on the restarts
+static void resonator_init(const HV Codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK], HV Estimate_HV[RESONATOR_FACTORS], int attempt)
+{
+    int weights[RESONATOR_CODEBOOK];
+    for (int i = 0; i < RESONATOR_CODEBOOK; i++)
+        weights[i] = 1;
+    for (int f = 0; f < RESONATOR_FACTORS; f++) {
+        Estimate_HV[f].randomize(RESONATOR_SEED, attempt * RESONATOR_FACTORS + f);
+        if (attempt == 0)
+            resonator_project(weights, Codebooks[f], Estimate_HV[f]);
+    }
+}
+
+// Entry of largest weight, i.e. nearest to the estimate
+static int resonator_argmax(const int weights[RESONATOR_CODEBOOK])
+{
+    int best = 0;
+    for (int i = 1; i < RESONATOR_CODEBOOK; i++)
+        if (weights[i] > weights[best])
+            best = i;
+    return best;
+}
+
+// A fixed point is accepted if its factors rebuild the product within a quarter of the bits
+static int resonator_valid(HDC_op& hdc, const HV& product, const HV Codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK], const int Factors[RESONATOR_FACTORS])
+{
+    HV Product_HV;
+    for (int f = 0; f < RESONATOR_FACTORS; f++)
+        Product_HV = hdc.bind(Product_HV, Codebooks[f][Factors[f]]);
+    return hdc.similarity(Product_HV, product) < HV_SIZE_BIT / 4;
+}
+
+int HDC_op::resonator(const HV& product, const HV Codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK], int Factors[RESONATOR_FACTORS])
+{
+    HV Estimate_HV[RESONATOR_FACTORS];
+    int weights[RESONATOR_CODEBOOK];
+    int attempt = 0;
+
+    // 1) Initial estimates
+    resonator_init(Codebooks, Estimate_HV, attempt);
+
+    for (int iteration = 1; iteration <= RESONATOR_MAX_ITER; iteration++) {
+        int changed = 0;
+        for (int f = 0; f < RESONATOR_FACTORS; f++) {
+            // 2) Unbind the other estimates
+            HV Unbound_HV = product;
+            for (int g = 0; g < RESONATOR_FACTORS; g++)
+                if (g != f)
+                    Unbound_HV = this->bind(Unbound_HV, Estimate_HV[g]);
+
+            // 3) Bipolar similarities with the codebook and projection
+            for (int i = 0; i < RESONATOR_CODEBOOK; i++)
+                weights[i] = HV_SIZE_BIT - 2 * this->similarity(Unbound_HV, Codebooks[f][i]);
+            changed |= resonator_project(weights, Codebooks[f], Estimate_HV[f]);
+            Factors[f] = resonator_argmax(weights);
+        }
+        // 4) Convergence: no estimate changed during the iteration, restart if the fixed point is spurious
+        if (!changed) {
+            if (resonator_valid(*this, product, Codebooks, Factors))
+                return iteration;
+            resonator_init(Codebooks, Estimate_HV, ++attempt);
+        }
+    }
+    return -1;
+}
+
+// Same iterations, with the unbinding (hvbind) and the similarities (hvsim) on the HDCU. The projection
+// is in software: the hvdec instruction declared in dsp_functions.h is not decoded by the HDCU.
+int HDC_op::accl_resonator(int product_addr, int codebook_addr, const HV Codebooks[RESONATOR_FACTORS][RESONATOR_CODEBOOK], int Factors[RESONATOR_FACTORS])
+{
+    HV Estimate_HV[RESONATOR_FACTORS];
+    HV Product_HV;
+    int weights[RESONATOR_CODEBOOK];
+    int hamming_distance;
+    int attempt = 0;
+
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    hvmemstr(&Product_HV.chunk[0], (void*)((int*)product_addr), sizeof(Product_HV));
+
+    // 1) Initial estimates
+    resonator_init(Codebooks, Estimate_HV, attempt);
+    for (int f = 0; f < RESONATOR_FACTORS; f++)
+        hvmemld(RESONATOR_SLOT(f), &Estimate_HV[f].chunk[0], HV_CHUNKS * 4);
+
+    for (int iteration = 1; iteration <= RESONATOR_MAX_ITER; iteration++) {
+        int changed = 0;
+        for (int f = 0; f < RESONATOR_FACTORS; f++) {
+            // 2) Unbind the other estimates
+            void* source = (void*)((int*)product_addr);
+            for (int g = 0; g < RESONATOR_FACTORS; g++) {
+                if (g != f) {
+                    hvbind(RESONATOR_SLOT(RESONATOR_U), source, RESONATOR_SLOT(g));
+                    source = RESONATOR_SLOT(RESONATOR_U);
+                }
+            }
+
+            // 3) Bipolar similarities with the codebook and projection
+            for (int i = 0; i < RESONATOR_CODEBOOK; i++) {
+                hvsim(RESONATOR_SLOT(RESONATOR_DIST), (void*)((int*)codebook_addr + (f * RESONATOR_CODEBOOK + i) * HV_CHUNKS), RESONATOR_SLOT(RESONATOR_U));
+                hvmemstr(&hamming_distance, RESONATOR_SLOT(RESONATOR_DIST), sizeof(int));
+                weights[i] = HV_SIZE_BIT - 2 * hamming_distance;
+            }
+            if (resonator_project(weights, Codebooks[f], Estimate_HV[f])) {
+                hvmemld(RESONATOR_SLOT(f), &Estimate_HV[f].chunk[0], HV_CHUNKS * 4);
+                changed = 1;
+            }
+            Factors[f] = resonator_argmax(weights);
+        }
+        // 4) Convergence: no estimate changed during the iteration, restart if the fixed point is spurious
+        if (!changed) {
+            if (resonator_valid(*this, Product_HV, Codebooks, Factors))
+                return iteration;
+            resonator_init(Codebooks, Estimate_HV, ++attempt);
+            for (int f = 0; f < RESONATOR_FACTORS; f++)
+                hvmemld(RESONATOR_SLOT(f), &Estimate_HV[f].chunk[0], HV_CHUNKS * 4);
+        }
+    }
+    return -1;
+}
+// --------------------End Resonator Network----------------------
+
+// --------------------Sparse HVs----------------------
+// Sparse HVs keep only the sorted positions of their ones, so their cost grows with the number of
+// ones instead of HV_SIZE. Binding splits the HVs in segments of SPARSE_SEGMENT_LEN positions and rotates
+// the ones of 'a' inside each segment by an amount given by the ones of 'b' in that segment and in the next
+// one: it keeps the density, is exactly invertible, has (SPARSE_SEGMENT_LEN)^segments binders, and keys that
+// differ in a few positions only change the segments around them, so similar keys give similar bound HVs.
+// Bundling keeps the most frequent positions so that the result has the same density as the inputs.
+
+// Tie break of the sparse bundling: positions with the same count are kept in a pseudo random order
+#define SPARSE_TIE_SEED 0x7153u
+
+SparseHV HDC_op::sparse_random()
+{
+    SparseHV Sparse_HV;
+    Sparse_HV.randomize(rng, (int)(sparsity_factor * HV_SIZE));
+    return Sparse_HV;
+}
+
+// Rotation of segment s of 'a' by shift[s]: every segment stays in place, so the list stays sorted
+// once the ones of each segment are sorted again
+static SparseHV sparse_rotate_segments(const SparseHV& a, const int shift[])
+{
+    SparseHV Rotated_HV;
+    Rotated_HV.ones = a.ones;
+    int first = 0;
+    while (first < a.ones) {
+        int segment = a.index[first] / SPARSE_SEGMENT_LEN;
+        int last = first;
+        while (last < a.ones && a.index[last] / SPARSE_SEGMENT_LEN == segment)
+            last++;
+        for (int i = first; i < last; i++) {
+            int offset = (a.index[i] % SPARSE_SEGMENT_LEN + shift[segment]) % SPARSE_SEGMENT_LEN;
+            uint16_t position = (uint16_t)(segment * SPARSE_SEGMENT_LEN + offset);
+            int j = i;
+            for (; j > first && Rotated_HV.index[j - 1] > position; j--)
+                Rotated_HV.index[j] = Rotated_HV.index[j - 1];
+            Rotated_HV.index[j] = position;
+        }
+        first = last;
+    }
+    return Rotated_HV;
+}
+
+// Shift of each segment: sum of (offset + 1) of the ones of 'b' in the segment and in the next one (cyclic),
+// the next segment makes a segment without ones of 'b' unlikely to be left unchanged
+static void sparse_shifts(const SparseHV& b, int size, int shift[])
+{
+    int segments = size / SPARSE_SEGMENT_LEN;
+    int weight[HV_SIZE_BIT / SPARSE_SEGMENT_LEN];
+    for (int s = 0; s < segments; s++)
+        weight[s] = 0;
+    for (int i = 0; i < b.ones; i++)
+        weight[b.index[i] / SPARSE_SEGMENT_LEN] += b.index[i] % SPARSE_SEGMENT_LEN + 1;
+    for (int s = 0; s < segments; s++)
+        shift[s] = (weight[s] + weight[(s + 1) % segments]) % SPARSE_SEGMENT_LEN;
+}
+
+SparseHV HDC_op::bind(const SparseHV& a, const SparseHV& b)
+{
+    int shift[HV_SIZE_BIT / SPARSE_SEGMENT_LEN];
+    sparse_shifts(b, HV_SIZE, shift);
+    return sparse_rotate_segments(a, shift);
+}
+
+SparseHV HDC_op::unbind(const SparseHV& a, const SparseHV& b)
+{
+    int shift[HV_SIZE_BIT / SPARSE_SEGMENT_LEN];
+    sparse_shifts(b, HV_SIZE, shift);
+    for (int s = 0; s < HV_SIZE / SPARSE_SEGMENT_LEN; s++)
+        shift[s] = (SPARSE_SEGMENT_LEN - shift[s]) % SPARSE_SEGMENT_LEN;
+    return sparse_rotate_segments(a, shift);
+}
+
+// 1) Count the positions of the inputs, 2) find the count above which fewer than the target positions
+// remain, 3) keep those and fill up with the positions at that count of smallest tie break hash
+SparseHV HDC_op::bundle(const SparseHV inputs[], int count)
+{
+    uint8_t counter[HV_SIZE_BIT];
+    uint16_t seen[HV_SIZE_BIT];
+    int histogram[256];
+    int unique = 0;
+    int target = (int)(sparsity_factor * HV_SIZE);
+    target = target > SPARSE_MAX_ONES ? SPARSE_MAX_ONES : target;
+
+    // 1) Counters of the positions, only the touched ones are initialized
+    for (int n = 0; n < count; n++)
+        for (int i = 0; i < inputs[n].ones; i++)
+            counter[inputs[n].index[i]] = 0;
+    for (int c = 0; c < 256; c++)
+        histogram[c] = 0;
+    for (int n = 0; n < count; n++) {
+        for (int i = 0; i < inputs[n].ones; i++) {
+            int position = inputs[n].index[i];
+            if (counter[position] == 0)
+                seen[unique++] = (uint16_t)position;
+            if (counter[position] < 255)
+                counter[position]++;
+        }
+    }
+    for (int u = 0; u < unique; u++)
+        histogram[counter[seen[u]]]++;
+
+    // 2) Threshold count
+    int threshold = 255, above = 0;
+    while (threshold > 0 && above + histogram[threshold] <= target)
+        above += histogram[threshold--];
+
+    // 3) Positions above the threshold, then the ties of smallest hash, in sorted order
+    SparseHV Bundled_HV;
+    uint32_t tie_hash[SPARSE_MAX_ONES];
+    uint16_t tie_position[SPARSE_MAX_ONES];
+    int ties = 0;
+    int free_slots = threshold > 0 ? target - above : 0;
+    for (int u = 0; u < unique; u++) {
+        int position = seen[u];
+        if (counter[position] > threshold) {
+            Bundled_HV.index[Bundled_HV.ones++] = (uint16_t)position;
+        } else if (counter[position] == threshold && free_slots > 0) {
+            uint32_t hash = hv_hash(SPARSE_TIE_SEED, 0, position);
+            if (ties < free_slots) {
+                tie_hash[ties] = hash;
+                tie_position[ties++] = (uint16_t)position;
+            } else {
+                int worst = 0;
+                for (int t = 1; t < ties; t++)
+                    if (tie_hash[t] > tie_hash[worst])
+                        worst = t;
+                if (hash < tie_hash[worst]) {
+                    tie_hash[worst] = hash;
+                    tie_position[worst] = (uint16_t)position;
+                }
+            }
+        }
+    }
+    for (int t = 0; t < ties; t++)
+        Bundled_HV.index[Bundled_HV.ones++] = tie_position[t];
+
+    // Insertion sort: the list is short
+    for (int i = 1; i < Bundled_HV.ones; i++) {
+        uint16_t position = Bundled_HV.index[i];
+        int j = i;
+        for (; j > 0 && Bundled_HV.index[j - 1] > position; j--)
+            Bundled_HV.index[j] = Bundled_HV.index[j - 1];
+        Bundled_HV.index[j] = position;
+    }
+    return Bundled_HV;
+}
+
+// Merge of the two sorted lists
+int HDC_op::overlap(const SparseHV& a, const SparseHV& b)
+{
+    int common = 0;
+    int i = 0, j = 0;
+    while (i < a.ones && j < b.ones) {
+        if (a.index[i] == b.index[j]) {
+            common++;
+            i++;
+            j++;
+        } else if (a.index[i] < b.index[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    return common;
+}
+// --------------------End Sparse HVs----------------------
+
+// --------------------Block-Sparse HVs----------------------
+// One active position per block, stored as one byte per block. Binding adds the positions modulo
+// BLOCK_LEN and the similarity counts the equal positions; both work on four blocks per word, since
+// positions below 128 can be added without carries crossing the bytes.
+
+#define BLOCK_MASK  (0x01010101u * (BLOCK_LEN - 1))   // Position bits of the four bytes of a word
+#define BLOCK_TIE_SEED 0xB10Cu                        // Tie break of the block argmax
+
+void HDC_op::generate_BaseHVs(BlockHV baseVectors[DS_FEATURE_SIZE])
+{
+    for (int vec = 0; vec < DS_FEATURE_SIZE; vec++)
+        baseVectors[vec].randomize(rng);
+}
+
+// The changed blocks are nested (level l + 1 changes the blocks of level l and some more), each one to a
+// different position, so the similarity to level 0 decreases linearly with the level
+void HDC_op::generate_LevelVectors(BlockHV LevelVectors[HD_LV_LEN])
+{
+    LevelVectors[0].randomize(rng);
+    for (int l = 1; l < num_levels; l++) {
+        LevelVectors[l] = LevelVectors[l - 1];
+        int first = (l - 1) * BLOCK_COUNT / (2 * (num_levels - 1));
+        int last = l * BLOCK_COUNT / (2 * (num_levels - 1));
+        for (int b = first; b < last; b++)
+            LevelVectors[l].set(b, (LevelVectors[0].get(b) + 1 + rng.bounded(BLOCK_LEN - 1)) % BLOCK_LEN);
+    }
+}
+
+BlockHV HDC_op::bind(const BlockHV& a, const BlockHV& b)
+{
+    BlockHV Bound_HV;
+    for (int i = 0; i < BLOCK_WORDS; i++)
+        Bound_HV.word[i] = (a.word[i] + b.word[i]) & BLOCK_MASK;
+    return Bound_HV;
+}
+
+// a - b = a + (BLOCK_LEN - b): the complement of b is computed per byte without borrows
+BlockHV HDC_op::unbind(const BlockHV& a, const BlockHV& b)
+{
+    BlockHV Unbound_HV;
+    for (int i = 0; i < BLOCK_WORDS; i++)
+        Unbound_HV.word[i] = (a.word[i] + (0x01010101u * BLOCK_LEN - b.word[i])) & BLOCK_MASK;
+    return Unbound_HV;
+}
+
+// Equal bytes are the zero bytes of a ^ b: adding 0x7F to the low 7 bits of each byte sets its top bit
+// unless the byte is zero, so the top bits left clear count the matches
+int HDC_op::similarity(const BlockHV& a, const BlockHV& b)
+{
+    int matches = 0;
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        uint32_t x = a.word[i] ^ b.word[i];
+        uint32_t nonzero = ((x & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | x;
+        matches += __builtin_popcount(~nonzero & 0x80808080u);
+    }
+    return matches;
+}
+
+// Argmax of the counts of each block, ties broken by a fixed hash of (block, position)
+BlockHV HDC_op::bundle(const BlockHV inputs[], int count)
+{
+    BlockHV Bundled_HV;
+    for (int b = 0; b < BLOCK_COUNT; b++) {
+        int counter[BLOCK_LEN];
+        for (int p = 0; p < BLOCK_LEN; p++)
+            counter[p] = 0;
+        for (int n = 0; n < count; n++)
+            counter[inputs[n].get(b)]++;
+
+        int best = 0;
+        uint32_t best_hash = hv_hash(BLOCK_TIE_SEED, b, 0);
+        for (int p = 1; p < BLOCK_LEN; p++) {
+            if (counter[p] < counter[best])
+                continue;
+            uint32_t hash = hv_hash(BLOCK_TIE_SEED, b, p);
+            if (counter[p] > counter[best] || hash < best_hash) {
+                best = p;
+                best_hash = hash;
+            }
+        }
+        Bundled_HV.set(b, best);
+    }
+    return Bundled_HV;
+}
+
+BlockHV HDC_op::encoding(int quantized_features[DS_FEATURE_SIZE], BlockHV BaseVectors[DS_FEATURE_SIZE], BlockHV LevelVectors[HD_LV_LEN])
+{
+    // 1) BIND the level vector with the corresponding base vector
+    BlockHV binded_feature[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        binded_feature[i] = this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]);
+
+    // 2) Bundle: block argmax
+    return this->bundle(binded_feature, DS_FEATURE_SIZE);
+}
+
+int HDC_op::Search(const BlockHV& QueryHV, const BlockHV associativeMemory[HD_CV_LEN])
+{
+    int bestMatches = -1;
+    int bestIndex = 0;
+    for (int j = 0; j < HD_CV_LEN; j++) {
+        int matches = this->similarity(QueryHV, associativeMemory[j]);
+        if (matches > bestMatches) {
+            bestMatches = matches;
+            bestIndex = j;
+        }
+    }
+    return bestIndex;
+}
+// --------------------End Block-Sparse HVs----------------------
+
+// --------------------Bipolar HVs----------------------
+// int8 elements, bound by multiplication and bundled in int16 sums that are clipped only when needed.
+// The dot products use AVX-512 VNNI or AVX2 on hosts that have them, a plain loop elsewhere (rv32).
+// On the HDCU the +1/-1 HVs are handled in binary form: their dot product is D - 2 * hamming (hvsim),
+// since KDOTPPS is decoded but has no datapath in the HDC unit.
+
+BipolarHV HDC_op::bipolar_random()
+{
+    HV Binary_HV;
+    BipolarHV Bipolar_HV;
+    Binary_HV.randomize(rng);
+    Bipolar_HV.from_binary(Binary_HV, base_value);
+    return Bipolar_HV;
+}
+
+BipolarHV HDC_op::bind(const BipolarHV& a, const BipolarHV& b)
+{
+    BipolarHV Bound_HV;
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        int product = a.element[d] * b.element[d];
+        product = product > 127 ? 127 : (product < -128 ? -128 : product);
+        Bound_HV.element[d] = (int8_t)product;
+    }
+    return Bound_HV;
+}
+
+bool HDC_op::bundle(BundledBipolarHV& bundled_hv, const BipolarHV& hv)
+{
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        int sum = bundled_hv.element[d] + hv.element[d];
+        if (sum > INT16_MAX || sum < INT16_MIN)
+            return false;
+    }
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        bundled_hv.element[d] += hv.element[d];
+    return true;
+}
+
+BipolarHV HDC_op::clip(const BundledBipolarHV& bundled_hv)
+{
+    BipolarHV Clipped_HV;
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        Clipped_HV.element[d] = (int8_t)(bundled_hv.element[d] < 0 ? -base_value : base_value);
+    return Clipped_HV;
+}
+
+// int8 x int8 dot product
+int HDC_op::dot(const BipolarHV& a, const BipolarHV& b)
+{
+    int d = 0;
+    int sum = 0;
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    // dpbusd multiplies unsigned by signed bytes: a * b = (a + 128) * b - 128 * b
+    __m512i products = _mm512_setzero_si512();
+    __m512i b_sum = _mm512_setzero_si512();
+    const __m512i bias = _mm512_set1_epi8((char)0x80);
+    const __m512i ones = _mm512_set1_epi8(1);
+    for (; d + 64 <= HV_SIZE_BIT; d += 64) {
+        __m512i va = _mm512_loadu_si512((const void*)&a.element[d]);
+        __m512i vb = _mm512_loadu_si512((const void*)&b.element[d]);
+        products = _mm512_dpbusd_epi32(products, _mm512_xor_si512(va, bias), vb);
+        b_sum = _mm512_dpbusd_epi32(b_sum, ones, vb);
+    }
+    sum = _mm512_reduce_add_epi32(products) - 128 * _mm512_reduce_add_epi32(b_sum);
+#elif defined(__AVX2__)
+    // Widened to int16: maddubs on |a| and sign(b, a) is wrong for -128 (|-128| and -(-128) overflow)
+    // and saturates pairs of 128 * 128 products
+    __m256i products = _mm256_setzero_si256();
+    for (; d + 16 <= HV_SIZE_BIT; d += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)&a.element[d]));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)&b.element[d]));
+        products = _mm256_add_epi32(products, _mm256_madd_epi16(va, vb));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(products), _mm256_extracti128_si256(products, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    sum = _mm_cvtsi128_si32(half);
+#endif
+    for (; d < HV_SIZE_BIT; d++)
+        sum += a.element[d] * b.element[d];
+    return sum;
+}
+
+// int16 x int8 dot product
+int HDC_op::dot(const BundledBipolarHV& a, const BipolarHV& b)
+{
+    int d = 0;
+    int sum = 0;
+#if defined(__AVX512BW__)
+    __m512i products = _mm512_setzero_si512();
+    for (; d + 32 <= HV_SIZE_BIT; d += 32) {
+        __m512i va = _mm512_loadu_si512((const void*)&a.element[d]);
+        __m512i vb = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)&b.element[d]));
+        products = _mm512_add_epi32(products, _mm512_madd_epi16(va, vb));
+    }
+    sum = _mm512_reduce_add_epi32(products);
+#elif defined(__AVX2__)
+    __m256i products = _mm256_setzero_si256();
+    for (; d + 16 <= HV_SIZE_BIT; d += 16) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)&a.element[d]);
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)&b.element[d]));
+        products = _mm256_add_epi32(products, _mm256_madd_epi16(va, vb));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(products), _mm256_extracti128_si256(products, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    sum = _mm_cvtsi128_si32(half);
+#endif
+    for (; d < HV_SIZE_BIT; d++)
+        sum += a.element[d] * b.element[d];
+    return sum;
+}
+
+int HDC_op::Search(const BipolarHV& QueryHV, const BundledBipolarHV associativeMemory[HD_CV_LEN])
+{
+    int bestDot = 0;
+    int bestIndex = -1;
+    for (int j = 0; j < HD_CV_LEN; j++) {
+        int product = this->dot(associativeMemory[j], QueryHV);
+        if (bestIndex < 0 || product > bestDot) {
+            bestDot = product;
+            bestIndex = j;
+        }
+    }
+    return bestIndex;
+}
+
+int HDC_op::accl_dot(int a_addr, int b_addr)
+{
+    int hamming_distance;
+
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    hvsim((void*)((int*)spmaddrC), (void*)((int*)a_addr), (void*)((int*)b_addr));
+    hvmemstr(&hamming_distance, (void*)((int*)spmaddrC), sizeof(int));
+
+    return base_value * base_value * (HV_SIZE_BIT - 2 * hamming_distance);
+}
+// --------------------End Bipolar HVs----------------------
+
+// --------------------Cosine Search----------------------
+// A binary query q (bipolar 1 - 2 q_d) against a class with n samples and counts c_d (bipolar n - 2 c_d):
+// dot = n D - 2 C - 2 n |q| + 4 sum_{q_d = 1} c_d, with C = sum c_d. The last sum is computed on the
+// bit planes of the counters: sum_p 2^p popcount(q & plane_p). The norm of the query is the same for all
+// the classes, so the cosine ranking only needs the cached inverse norms of the classes.
+
+ClassAccumulator::ClassAccumulator() {
+    samples = 0;
+    sum = 0;
+    squares = 0;
+    inv_norm = 0;
+}
+
+// sum of the counts at the positions of the ones of an HV
+static int64_t masked_count(const SlicedHV& counters, const HV& hv)
+{
+    int64_t total = 0;
+    for (int p = 0; p < SLICED_PLANES; p++) {
+        int ones = 0;
+        for (int c = 0; c < HV_CHUNKS; c++)
+            ones += __builtin_popcount((uint32_t)(counters.plane[p][c] & hv.chunk[c]));
+        total += (int64_t)ones << p;
+    }
+    return total;
+}
+
+static int hv_ones(const HV& hv)
+{
+    int ones = 0;
+    for (int c = 0; c < HV_CHUNKS; c++)
+        ones += __builtin_popcount((uint32_t)hv.chunk[c]);
+    return ones;
+}
+
+// The counts at the ones of the sample grow by one: sum c_d^2 grows by 2 * (their previous sum) + |x|
+bool HDC_op::train(ClassAccumulator& class_hv, const HV& sample)
+{
+    if (class_hv.samples >= (1 << SLICED_PLANES) - 1)
+        return false;
+
+    int64_t previous = masked_count(class_hv.counters, sample);
+    int ones = hv_ones(sample);
+
+    class_hv.counters.add(sample);
+    class_hv.samples++;
+    class_hv.sum += ones;
+    class_hv.squares += 2 * previous + ones;
+
+    // ||s||^2 = sum (n - 2 c_d)^2 = D n^2 - 4 n C + 4 sum c_d^2
+    int64_t n = class_hv.samples;
+    int64_t norm2 = (int64_t)HV_SIZE_BIT * n * n - 4 * n * class_hv.sum + 4 * class_hv.squares;
+    class_hv.inv_norm = norm2 > 0 ? 1.0f / sqrtf((float)norm2) : 0.0f;
+    return true;
+}
+
+int HDC_op::dot(const ClassAccumulator& class_hv, const HV& QueryHV)
+{
+    int64_t n = class_hv.samples;
+    int64_t product = (int64_t)HV_SIZE_BIT * n - 2 * class_hv.sum - 2 * n * hv_ones(QueryHV) + 4 * masked_count(class_hv.counters, QueryHV);
+    return (int)product;
+}
+
+int HDC_op::Search(const HV& QueryHV, const ClassAccumulator associativeMemory[HD_CV_LEN])
+{
+    int bestIndex = 0;
+
+    if (HV_similarity == 1) {
+        float bestScore = -FLT_MAX;
+        for (int j = 0; j < HD_CV_LEN; j++) {
+            float score = this->dot(associativeMemory[j], QueryHV) * associativeMemory[j].inv_norm;
+            if (score > bestScore) {
+                bestScore = score;
+                bestIndex = j;
+            }
+        }
+    } else {
+        int bestDistance = HV_SIZE_BIT + 1;
+        for (int j = 0; j < HD_CV_LEN; j++) {
+            int distance = this->similarity(QueryHV, this->clip(associativeMemory[j].counters, associativeMemory[j].samples));
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                bestIndex = j;
+            }
+        }
+    }
+    return bestIndex;
+}
+// --------------------End Cosine Search----------------------
+
+// --------------------Mixed-Precision Class----------------------
+// With the query in bipolar form (1 - 2 q_d), the score of a prototype is
+// sum_d (1 - 2 q_d) w_d = 2 sum_p 2^p (ones_p - 2 popcount(q & plane_p)) - (2^bits - 1) (D - 2 |q|).
+// The last term is the same for all the classes of the same precision and is dropped. Plane p adds a value
+// in [-2^p ones_p, 2^p ones_p], so after the most significant planes the remaining ones bound how much each
+// score can still move, and the search stops once no other class can reach the leader.
+
+MixedPrecisionClass::MixedPrecisionClass() {
+    bits = 1;
+    for (int p = 0; p < MIXED_MAX_BITS; p++) {
+        plane_ones[p] = 0;
+        for (int c = 0; c < HV_CHUNKS; c++)
+            plane[p][c] = 0;
+    }
+}
+
+// The mean bipolar value (n - 2 c_d) / n in [-1, 1] is mapped linearly and rounded to u_d in [0, 2^bits - 1]:
+// u_d = round((n - c_d) (2^bits - 1) / n)
+MixedPrecisionClass HDC_op::quantize_class(const ClassAccumulator& class_hv, int bits)
+{
+    MixedPrecisionClass prototype;
+    prototype.bits = bits;
+    int n = class_hv.samples > 0 ? class_hv.samples : 1;
+    int levels = (1 << bits) - 1;
+
+    for (int c = 0; c < HV_CHUNKS; c++) {
+        for (int b = 0; b < 32; b++) {
+            int count = class_hv.counters.get_counter(c, b);
+            int u = (2 * (n - count) * levels + n) / (2 * n);
+            for (int p = 0; p < bits; p++)
+                prototype.plane[p][c] |= ((u >> p) & 1) << b;
+        }
+    }
+    for (int p = 0; p < bits; p++)
+        for (int c = 0; c < HV_CHUNKS; c++)
+            prototype.plane_ones[p] += __builtin_popcount((uint32_t)prototype.plane[p][c]);
+    return prototype;
+}
+
+int HDC_op::Search(const HV& QueryHV, const MixedPrecisionClass associativeMemory[HD_CV_LEN], int planes, int& used_planes)
+{
+    int64_t score[HD_CV_LEN], remaining[HD_CV_LEN];
+    int first[HD_CV_LEN];
+    int bestIndex = 0;
+
+    // 1) Planes evaluated for each class and the bound of what they can add
+    for (int j = 0; j < HD_CV_LEN; j++) {
+        int bits = associativeMemory[j].bits;
+        first[j] = bits > planes ? bits - planes : 0;
+        score[j] = 0;
+        remaining[j] = 0;
+        for (int p = first[j]; p < bits; p++)
+            remaining[j] += (int64_t)associativeMemory[j].plane_ones[p] << p;
+    }
+
+    // 2) Most significant planes first, step k evaluates plane bits - 1 - k of every class
+    used_planes = 0;
+    for (int k = 0; k < planes && k < MIXED_MAX_BITS; k++) {
+        bool evaluated = false;
+        for (int j = 0; j < HD_CV_LEN; j++) {
+            int p = associativeMemory[j].bits - 1 - k;
+            if (p < first[j])
+                continue;
+            int ones = 0;
+            for (int c = 0; c < HV_CHUNKS; c++)
+                ones += __builtin_popcount((uint32_t)(associativeMemory[j].plane[p][c] & QueryHV.chunk[c]));
+            score[j] += (int64_t)(associativeMemory[j].plane_ones[p] - 2 * ones) << p;
+            remaining[j] -= (int64_t)associativeMemory[j].plane_ones[p] << p;
+            evaluated = true;
+        }
+        if (!evaluated)
+            break;
+        used_planes++;
+
+        // 3) Early exit: the worst case of the leader beats the best case of every other class
+        bestIndex = 0;
+        for (int j = 1; j < HD_CV_LEN; j++)
+            if (score[j] > score[bestIndex])
+                bestIndex = j;
+        bool decided = true;
+        for (int j = 0; j < HD_CV_LEN && decided; j++)
+            if (j != bestIndex && score[j] + remaining[j] >= score[bestIndex] - remaining[bestIndex])
+                decided = false;
+        if (decided)
+            break;
+    }
+    return bestIndex;
+}
+
+int HDC_op::Search(const HV& QueryHV, const MixedPrecisionClass associativeMemory[HD_CV_LEN], int planes)
+{
+    int used_planes;
+    return this->Search(QueryHV, associativeMemory, planes, used_planes);
+}
+// --------------------End Mixed-Precision Class----------------------
+
+// Word w of the spatial encoding: bind the words of the level and base HVs of each feature and take their
+// majority, with the same threshold as clip(): counter > DS_FEATURE_SIZE / 2
+static uint32_t encoded_word(const HV* Levels[DS_FEATURE_SIZE], const HV BaseVectors[DS_FEATURE_SIZE], int w)
+{
+    uint32_t bound[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        bound[i] = (uint32_t)(Levels[i]->chunk[w] ^ BaseVectors[i].chunk[w]);
+    uint32_t encoded = 0;
+    for (int b = 0; b < 32; b++) {
+        int counter = 0;
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            counter += (bound[i] >> b) & 1;
+        encoded |= (uint32_t)(counter > DS_FEATURE_SIZE / 2) << b;
+    }
+    return encoded;
+}
+
+// --------------------Compact Model----------------------
+// Offline compaction of a trained model. A dimension separates the classes as much as their mean bipolar
+// values m_cd = (n_c - 2 c_cd) / n_c differ, so the dimensions are ranked by the variance of m_cd across
+// the classes: dimensions where all the classes agree (or are all undecided) cost a query as much as the
+// others but don't change its ranking. Binding and bundling work element by element, so encoding with the
+// gathered item memories gives the gathered encoding of the full model and the compact model only touches
+// dimensions / 32 chunks per HV.
+
+CompactModel::CompactModel() {
+    dimensions = 0;
+    for (int k = 0; k < HV_SIZE_BIT; k++)
+        gather[k] = 0;
+}
+
+void HDC_op::rank_dimensions(const ClassAccumulator ClassVectors[HD_CV_LEN], uint16_t ranking[HV_SIZE_BIT])
+{
+    float variance[HV_SIZE_BIT];
+
+    // 1) Variance across the classes of the mean bipolar values
+    for (int d = 0; d < HV_SIZE_BIT; d++) {
+        float sum = 0, squares = 0;
+        for (int c = 0; c < HD_CV_LEN; c++) {
+            int n = ClassVectors[c].samples > 0 ? ClassVectors[c].samples : 1;
+            float mean = (float)(ClassVectors[c].samples - 2 * ClassVectors[c].counters.get_counter(d / 32, d % 32)) / n;
+            sum += mean;
+            squares += mean * mean;
+        }
+        variance[d] = squares / HD_CV_LEN - (sum / HD_CV_LEN) * (sum / HD_CV_LEN);
+        ranking[d] = d;
+    }
+
+    // 2) Shell sort by decreasing variance, lower dimensions first on ties
+    for (int gap = HV_SIZE_BIT / 2; gap > 0; gap /= 2) {
+        for (int i = gap; i < HV_SIZE_BIT; i++) {
+            uint16_t d = ranking[i];
+            int j = i;
+            while (j >= gap && (variance[ranking[j - gap]] < variance[d] ||
+                                (variance[ranking[j - gap]] == variance[d] && ranking[j - gap] > d))) {
+                ranking[j] = ranking[j - gap];
+                j -= gap;
+            }
+            ranking[j] = d;
+        }
+    }
+}
+
+HV HDC_op::gather(const HV& hv, const uint16_t gather[], int dimensions)
+{
+    HV gathered;
+    for (int k = 0; k < dimensions; k++)
+        gathered.chunk[k / 32] |= (int)((((uint32_t)hv.chunk[gather[k] / 32] >> (gather[k] % 32)) & 1) << (k % 32));
+    return gathered;
+}
+
+bool HDC_op::compact_model(const ClassAccumulator ClassVectors[HD_CV_LEN], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], int dimensions, CompactModel& model)
+{
+    if (dimensions < 32 || dimensions > HV_SIZE_BIT || dimensions % 32 != 0) {
+        model.dimensions = 0;
+        return false;
+    }
+    uint16_t ranking[HV_SIZE_BIT];
+    this->rank_dimensions(ClassVectors, ranking);
+
+    // 1) Gather map: the top ranked dimensions, in increasing order
+    bool kept[HV_SIZE_BIT];
+    for (int d = 0; d < HV_SIZE_BIT; d++)
+        kept[d] = false;
+    for (int k = 0; k < dimensions; k++)
+        kept[ranking[k]] = true;
+    model.dimensions = dimensions;
+    for (int d = 0, k = 0; d < HV_SIZE_BIT; d++)
+        if (kept[d])
+            model.gather[k++] = d;
+
+    // 2) Item memories and class memory
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        model.BaseVectors[i] = this->gather(BaseVectors[i], model.gather, dimensions);
+    for (int l = 0; l < HD_LV_LEN; l++)
+        model.LevelVectors[l] = this->gather(LevelVectors[l], model.gather, dimensions);
+    for (int c = 0; c < HD_CV_LEN; c++)
+        model.ClassVectors[c] = this->gather(this->clip(ClassVectors[c].counters, ClassVectors[c].samples), model.gather, dimensions);
+    return true;
+}
+
+HV HDC_op::compact_encoding(int quantized_features[DS_FEATURE_SIZE], const CompactModel& model)
+{
+    HV Encoded_HV;
+    const HV* Levels[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        Levels[i] = &model.LevelVectors[quantized_features[i]];
+
+    for (int c = 0; c < model.dimensions / 32; c++)
+        Encoded_HV.chunk[c] = (int)encoded_word(Levels, model.BaseVectors, c);
+    return Encoded_HV;
+}
+
+int HDC_op::Search(const HV& QueryHV, const CompactModel& model)
+{
+    int bestDistance = HV_SIZE_BIT + 1;
+    int bestIndex = 0;
+
+    for (int j = 0; j < HD_CV_LEN; j++) {
+        int distance = 0;
+        for (int c = 0; c < model.dimensions / 32; c++)
+            distance += __builtin_popcount((uint32_t)(QueryHV.chunk[c] ^ model.ClassVectors[j].chunk[c]));
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            bestIndex = j;
+        }
+    }
+    return bestIndex;
+}
+// --------------------End Compact Model----------------------
+
+// --------------------Hierarchical Memory----------------------
+// The query is compared with the super-vectors first and only the classes of the nearest groups are searched,
+// so a search costs groups + (classes in the selected groups) comparisons instead of num_classes. Similar
+// classes are grouped by k-means, whose centroids are the bundles of the groups clipped to a majority: a
+// super-vector is closer to its own classes than to unrelated ones, and top_groups trades recall for speed.
+// The groups can hold more classes than the 4-bit counters of BundledHV, so the bundles are bit-sliced:
+// HIER_MAX_CLASSES keeps even a single group within their 2^SLICED_PLANES - 1 samples.
+
+HierarchicalMemory::HierarchicalMemory() {
+    num_classes = 0;
+    groups = 0;
+    for (int g = 0; g <= HIER_MAX_GROUPS; g++)
+        group_start[g] = 0;
+}
+
+bool HDC_op::build_hierarchy(const HV ClassVectors[], int num_classes, int groups, int iterations, HierarchicalMemory& memory)
+{
+    static uint8_t group_of[HIER_MAX_CLASSES];
+    static SlicedHV bundled[HIER_MAX_GROUPS];
+    memory.num_classes = 0;
+    memory.groups = 0;
+    if (groups < 1 || groups > HIER_MAX_GROUPS || num_classes < groups || num_classes > HIER_MAX_CLASSES)
+        return false;
+    memory.num_classes = num_classes;
+    memory.groups = groups;
+
+    // 1) Initial super-vectors: evenly spaced classes
+    for (int g = 0; g < groups; g++)
+        memory.super[g] = ClassVectors[g * num_classes / groups];
+
+    for (int it = 0; it <= iterations; it++) {
+        // 2) Assignment of each class to the nearest super-vector
+        for (int c = 0; c < num_classes; c++)
+            group_of[c] = this->cleanup(ClassVectors[c], memory.super, groups, HV_CHUNKS);
+        if (it == iterations)
+            break;
+
+        // 3) Super-vectors: majority of the classes of each group (an empty group keeps its super-vector)
+        for (int g = 0; g < groups; g++)
+            bundled[g] = SlicedHV();
+        for (int c = 0; c < num_classes; c++)
+            bundled[group_of[c]].add(ClassVectors[c]);
+        for (int g = 0; g < groups; g++)
+            if (bundled[g].count > 0)
+                memory.super[g] = this->clip(bundled[g], bundled[g].count);
+    }
+
+    // 4) Member lists, grouped by counting sort
+    for (int g = 0; g <= groups; g++)
+        memory.group_start[g] = 0;
+    for (int c = 0; c < num_classes; c++)
+        memory.group_start[group_of[c] + 1]++;
+    for (int g = 0; g < groups; g++)
+        memory.group_start[g + 1] += memory.group_start[g];
+    int next[HIER_MAX_GROUPS];
+    for (int g = 0; g < groups; g++)
+        next[g] = memory.group_start[g];
+    for (int c = 0; c < num_classes; c++)
+        memory.member[next[group_of[c]]++] = c;
+    return true;
+}
+
+int HDC_op::Search(const HV& QueryHV, const HV ClassVectors[], const HierarchicalMemory& memory, int top_groups, int& compared)
+{
+    int group_distance[HIER_MAX_GROUPS];
+    bool selected[HIER_MAX_GROUPS];
+
+    // 1) Distances to the super-vectors
+    for (int g = 0; g < memory.groups; g++) {
+        group_distance[g] = 0;
+        for (int i = 0; i < HV_CHUNKS; i++)
+            group_distance[g] += __builtin_popcount((uint32_t)(QueryHV.chunk[i] ^ memory.super[g].chunk[i]));
+        selected[g] = false;
+    }
+    compared = memory.groups;
+
+    // 2) Exhaustive search of the top_groups nearest groups. Ties are resolved by the class index,
+    // so the search of all the groups gives the same class as a flat search
+    int bestDistance = HV_SIZE_BIT + 1;
+    int bestIndex = 0;
+    for (int k = 0; k < top_groups && k < memory.groups; k++) {
+        int nearest = -1;
+        for (int g = 0; g < memory.groups; g++)
+            if (!selected[g] && (nearest < 0 || group_distance[g] < group_distance[nearest]))
+                nearest = g;
+        selected[nearest] = true;
+
+        for (int m = memory.group_start[nearest]; m < memory.group_start[nearest + 1]; m++) {
+            int c = memory.member[m];
+            int distance = 0;
+            for (int i = 0; i < HV_CHUNKS; i++)
+                distance += __builtin_popcount((uint32_t)(QueryHV.chunk[i] ^ ClassVectors[c].chunk[i]));
+            if (distance < bestDistance || (distance == bestDistance && c < bestIndex)) {
+                bestDistance = distance;
+                bestIndex = c;
+            }
+        }
+        compared += memory.group_start[nearest + 1] - memory.group_start[nearest];
+    }
+    return bestIndex;
+}
+// --------------------End Hierarchical Memory----------------------
+
+// --------------------Ensemble----------------------
+// Running the members through inference() one by one repeats the quantization, the binding and the bundling
+// for every member. Here the input is quantized once, encoded once per item memory (only up to the longest
+// prefix its members use) and the class memories of all the members are searched in one pass over the words,
+// so each encoded word is loaded once for all the members reading it. The encoding cost grows with the
+// distinct item memories, not with the members.
+
+Ensemble::Ensemble() {
+    members = 0;
+    item_memories = 0;
+}
+
+int Ensemble::add_item_memory(const HV Base[DS_FEATURE_SIZE], const HV Level[HD_LV_LEN]) {
+    if (item_memories >= ENSEMBLE_MAX_MEMORIES)
+        return -1;
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        BaseVectors[item_memories][i] = Base[i];
+    for (int l = 0; l < HD_LV_LEN; l++)
+        LevelVectors[item_memories][l] = Level[l];
+    return item_memories++;
+}
+
+int Ensemble::add_member(int memory, int dimensions, const HV Classes[HD_CV_LEN]) {
+    if (members >= ENSEMBLE_MAX_MEMBERS || memory < 0 || memory >= item_memories)
+        return -1;
+    if (dimensions < 32 || dimensions > HV_SIZE_BIT || dimensions % 32 != 0)
+        return -1;
+    item_memory[members] = memory;
+    words[members] = dimensions / 32;
+    for (int c = 0; c < HD_CV_LEN; c++)
+        ClassVectors[members][c] = Classes[c];
+    return members++;
+}
+
+int HDC_op::ensemble_inference(const uint8_t quantized_features[DS_FEATURE_SIZE], const Ensemble& ensemble, int predictions[ENSEMBLE_MAX_MEMBERS])
+{
+    uint32_t encoded[ENSEMBLE_MAX_MEMORIES][HV_CHUNKS];
+    int distance[ENSEMBLE_MAX_MEMBERS][HD_CV_LEN];
+
+    // 1) Shared encoding: each item memory once, up to the longest prefix of its members
+    int needed[ENSEMBLE_MAX_MEMORIES];
+    for (int m = 0; m < ensemble.item_memories; m++)
+        needed[m] = 0;
+    for (int k = 0; k < ensemble.members; k++)
+        if (ensemble.words[k] > needed[ensemble.item_memory[k]])
+            needed[ensemble.item_memory[k]] = ensemble.words[k];
+    for (int m = 0; m < ensemble.item_memories; m++) {
+        const HV* Levels[DS_FEATURE_SIZE];
+        for (int i = 0; i < DS_FEATURE_SIZE; i++)
+            Levels[i] = &ensemble.LevelVectors[m][quantized_features[i]];
+        for (int w = 0; w < needed[m]; w++)
+            encoded[m][w] = encoded_word(Levels, ensemble.BaseVectors[m], w);
+    }
+
+    // 2) Batched search: one pass over the words for the class memories of all the members
+    for (int k = 0; k < ensemble.members; k++)
+        for (int c = 0; c < HD_CV_LEN; c++)
+            distance[k][c] = 0;
+    for (int w = 0; w < HV_CHUNKS; w++) {
+        for (int k = 0; k < ensemble.members; k++) {
+            if (w >= ensemble.words[k])
+                continue;
+            uint32_t query = encoded[ensemble.item_memory[k]][w];
+            for (int c = 0; c < HD_CV_LEN; c++)
+                distance[k][c] += __builtin_popcount(query ^ (uint32_t)ensemble.ClassVectors[k][c].chunk[w]);
+        }
+    }
+
+    // 3) Votes
+    int votes[HD_CV_LEN], total[HD_CV_LEN];
+    for (int c = 0; c < HD_CV_LEN; c++) {
+        votes[c] = 0;
+        total[c] = 0;
+    }
+    for (int k = 0; k < ensemble.members; k++) {
+        predictions[k] = 0;
+        for (int c = 0; c < HD_CV_LEN; c++) {
+            if (distance[k][c] < distance[k][predictions[k]])
+                predictions[k] = c;
+            total[c] += distance[k][c] * HV_CHUNKS / ensemble.words[k];
+        }
+        votes[predictions[k]]++;
+    }
+    int predicted_class = 0;
+    for (int c = 1; c < HD_CV_LEN; c++)
+        if (votes[c] > votes[predicted_class] || (votes[c] == votes[predicted_class] && total[c] < total[predicted_class]))
+            predicted_class = c;
+    return predicted_class;
+}
+
+void HDC_op::ensemble_inference_batch(const float features[][DS_FEATURE_SIZE], int samples, const UniformQuantizer& quantizer, const Ensemble& ensemble, int labels[])
+{
+    uint8_t quantized[ENSEMBLE_BATCH][DS_FEATURE_SIZE];
+    int predictions[ENSEMBLE_MAX_MEMBERS];
+
+    for (int first = 0; first < samples; first += ENSEMBLE_BATCH) {
+        int count = samples - first < ENSEMBLE_BATCH ? samples - first : ENSEMBLE_BATCH;
+        quantizer.quantize_batch(&features[first], count, quantized);
+        for (int s = 0; s < count; s++)
+            labels[first + s] = this->ensemble_inference(quantized[s], ensemble, predictions);
+    }
+}
+// --------------------End Ensemble----------------------
+
+// --------------------Regression----------------------
+// The dot product of a model HV with a binary HV in bipolar form is sum_d M_d - 2 sum_{x_d = 1} M_d: with the
+// sums of the model HVs kept up to date, a prediction only adds the weights at the ones of x. A single update
+// moves the prediction of its own sample by learning_rate * error, so 0 < learning_rate <= 1. Non-linear
+// targets are handled by the clusters, each fitting its own linear model on the samples close to it.
+
+RegressionModel::RegressionModel(int num_clusters, float rate) {
+    reset(num_clusters, rate);
+}
+
+// The clusters are clamped to [1, REG_MAX_CLUSTERS]
+void RegressionModel::reset(int num_clusters, float rate) {
+    clusters = num_clusters < 1 ? 1 : num_clusters > REG_MAX_CLUSTERS ? REG_MAX_CLUSTERS : num_clusters;
+    learning_rate = rate;
+    for (int k = 0; k < REG_MAX_CLUSTERS; k++) {
+        weight_sum[k] = 0;
+        for (int d = 0; d < HV_SIZE_BIT; d++)
+            weight[k][d] = 0;
+        center[k] = HV();
+        members[k] = SlicedHV();
+    }
+}
+
+// A cluster full of samples (2^SLICED_PLANES - 1) is folded by halving its counters, which keeps the
+// fraction of ones of every element, so that any number of samples per epoch can be assigned to it
+static void fold_members(SlicedHV& members)
+{
+    for (int p = 0; p < SLICED_PLANES - 1; p++)
+        for (int c = 0; c < HV_CHUNKS; c++)
+            members.plane[p][c] = members.plane[p + 1][c];
+    for (int c = 0; c < HV_CHUNKS; c++)
+        members.plane[SLICED_PLANES - 1][c] = 0;
+    members.count >>= 1;
+}
+
+// sum of the weights at the ones of an HV word
+static inline float masked_sum(const float weight[32], uint32_t bits)
+{
+    float sum = 0;
+    while (bits) {
+        sum += weight[__builtin_ctz(bits)];
+        bits &= bits - 1;
+    }
+    return sum;
+}
+
+void HDC_op::regression_init(RegressionModel& model, const HV Samples[], int count)
+{
+    model.clusters = model.clusters < 1 ? 1 : model.clusters > REG_MAX_CLUSTERS ? REG_MAX_CLUSTERS : model.clusters;
+    for (int k = 0; k < model.clusters; k++) {
+        model.center[k] = Samples[k * count / model.clusters];
+        model.members[k] = SlicedHV();
+    }
+}
+
+// Prediction of the model HV of cluster k
+static float predict_in_cluster(const RegressionModel& model, int k, const HV& sample)
+{
+    float masked = 0;
+    for (int w = 0; w < HV_CHUNKS; w++)
+        masked += masked_sum(&model.weight[k][w * 32], (uint32_t)sample.chunk[w]);
+    return (model.weight_sum[k] - 2 * masked) / HV_SIZE_BIT;
+}
+
+float HDC_op::regression_predict(const RegressionModel& model, const HV& sample)
+{
+    return predict_in_cluster(model, this->cleanup(sample, model.center, model.clusters, HV_CHUNKS), sample);
+}
+
+void HDC_op::regression_update(RegressionModel& model, const HV& sample, float target)
+{
+    int k = this->cleanup(sample, model.center, model.clusters, HV_CHUNKS);
+    float step = model.learning_rate * (target - predict_in_cluster(model, k, sample));
+
+    for (int w = 0; w < HV_CHUNKS; w++) {
+        uint32_t bits = (uint32_t)sample.chunk[w];
+        for (int b = 0; b < 32; b++)
+            model.weight[k][w * 32 + b] += ((bits >> b) & 1) ? -step : step;
+    }
+    int ones = 0;
+    for (int w = 0; w < HV_CHUNKS; w++)
+        ones += __builtin_popcount((uint32_t)sample.chunk[w]);
+    model.weight_sum[k] += step * (HV_SIZE_BIT - 2 * ones);
+    if (model.members[k].count >= (1 << SLICED_PLANES) - 1)
+        fold_members(model.members[k]);
+    model.members[k].add(sample);
+}
+
+void HDC_op::regression_train(RegressionModel& model, const HV Samples[], const float Targets[], int count, int epochs)
+{
+    for (int e = 0; e < epochs; e++) {
+        for (int s = 0; s < count; s++)
+            this->regression_update(model, Samples[s], Targets[s]);
+
+        // Clusters: majority of their samples, an empty cluster is kept
+        for (int k = 0; k < model.clusters; k++) {
+            if (model.members[k].count > 0)
+                model.center[k] = this->clip(model.members[k], model.members[k].count);
+            model.members[k] = SlicedHV();
+        }
+    }
+}
+
+void HDC_op::regression_predict_batch(const RegressionModel& model, const HV Samples[], int count, float Predictions[])
+{
+    for (int first = 0; first < count; first += REG_BATCH) {
+        int batch = count - first < REG_BATCH ? count - first : REG_BATCH;
+        int cluster[REG_BATCH];
+        float masked[REG_BATCH];
+        for (int s = 0; s < batch; s++) {
+            cluster[s] = this->cleanup(Samples[first + s], model.center, model.clusters, HV_CHUNKS);
+            masked[s] = 0;
+        }
+
+        // One pass over the words of the model HVs for the whole batch
+        for (int w = 0; w < HV_CHUNKS; w++)
+            for (int s = 0; s < batch; s++)
+                masked[s] += masked_sum(&model.weight[cluster[s]][w * 32], (uint32_t)Samples[first + s].chunk[w]);
+
+        for (int s = 0; s < batch; s++)
+            Predictions[first + s] = (model.weight_sum[cluster[s]] - 2 * masked[s]) / HV_SIZE_BIT;
+    }
+}
+// --------------------End Regression----------------------
+
+// --------------------Training----------------------
+BundledHV HDC_op::training(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], BundledHV ClassVectors[HD_CV_LEN], int class_label)
+{
+    // We first encode the input feature vector into an HDC vector
+    //HV encoded_hv = this->encoding(quantized_features, BaseVectors, LevelVectors);
+
+    BundledHV Encoded_HV;
+    
+    start_count();
+    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
+    HV binded_feature[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+    {
+        binded_feature[i] = this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]);
+    }
+    
+    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        Encoded_HV = this->bundle(Encoded_HV, binded_feature[i]);
+    }
+
+    // 4) Clip the HDC vector
+    HV Clipped_HV;
+    Clipped_HV = this->clip(Encoded_HV,DS_FEATURE_SIZE);
+
+    // We can now bundle the HDC vector with the corresponding class vector
+    ClassVectors[class_label] = this->bundle(ClassVectors[class_label], Clipped_HV);
+    int std_cycle = finish_count();
+    printf("Standard Execution: %d cycles\n", std_cycle);
+
+    return ClassVectors[class_label];
+}
+
+BundledHV HDC_op::accl_training(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr, BundledHV ClassVectors[HD_CV_LEN], int class_label)
+{
+    
+    // We first encode the input feature vector into an HDC vector
+    // this->accl_encoding(quantized_features, bv_start_addr, lv_start_addr);   // Note: at the end of encoding, the HDC vector is stored in _spmC if the last flag is set to 0
+
+    BundledHV Encoded_HV;
+    start_count();
+    CSR_MVSIZE(HV_CHUNKS * 4);
+
+    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4));
+    }
+    
+    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;
+    }
+
+    // 4) Clip the HDC vector
+    HV Clipped_HV;
+    hvclip((void*)((int*)spmaddrC), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
+    //hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));
+
+    int offset = class_label*HV_CHUNKS * 4;
+    // We can now bundle the HDC vector with the corresponding class vector using the hvbundle instruction
+    hvbundle((void*)((int*)spmaddrD+offset), (void*)((int*)spmaddrD+offset), (void*)((int*)spmaddrC)) ;
+    hvmemstr(&ClassVectors[class_label].bundled_chunk[0], (void*)((int*)spmaddrD+offset), sizeof(ClassVectors[class_label]));
+    int accl_cycle = finish_count();
+    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+
+    return ClassVectors[class_label];
+}
+// --------------------End Training----------------------
+
+// --------------------Inference----------------------
+int HDC_op::inference(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], HV ClassVectors[HD_CV_LEN])
+{
+    //HV encoded_hv = this->encoding(quantized_features, BaseVectors, LevelVectors);
+    // Encoding
+    
+
+    BundledHV Encoded_HV;
+    start_count();    
+    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
+    HV binded_feature[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        binded_feature[i] = this->bind(LevelVectors[quantized_features[i]], BaseVectors[i]);
+    }
+    
+    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        Encoded_HV = this->bundle(Encoded_HV, binded_feature[i]);
+    }
+
+    // 4) Clip the HDC vector
+    HV Clipped_HV;
+    Clipped_HV = this->clip(Encoded_HV,DS_FEATURE_SIZE);
+
+    int minimum_distance = HV_SIZE_BIT;
+    int predicted_class = -1;
+    for (int i = 0; i < HD_CV_LEN; i++){
+        int hamming_distance = this->similarity(Clipped_HV, ClassVectors[i]);
+        if (hamming_distance < minimum_distance)
+        {
+            minimum_distance = hamming_distance;
+            predicted_class = i;
+        }
+    }
+
+    int std_cycle = finish_count();
+    printf("Standard Execution: %d cycles\n", std_cycle);
+
+
+    return predicted_class;
+}
+
+int HDC_op::accl_inference(int quantized_features[DS_FEATURE_SIZE], int bv_start_addr, int lv_start_addr, HV ClassVectors[HD_CV_LEN])
+{
+    int minimum_distance = HV_SIZE_BIT;
+    int predicted_class = -1;
+    int hamming_distance;
+    
+    // We first encode the input feature vector into an HDC vector
+    //this->accl_encoding(quantized_features, bv_start_addr, lv_start_addr);   // Note: at the end of encoding, the HDC vector is stored in _spmC if the last flag is set to 0
+
+    BundledHV Encoded_HV;
+
+    start_count();
+    CSR_MVSIZE(HV_CHUNKS * 4);
+    // 2) BIND the level vector with the corresponding base vector (dependent by the number of the feature)
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        hvbind((void*)((int*)spmaddrC+i*HV_CHUNKS * 4), (void*)((int*)lv_start_addr+quantized_features[i]*HV_CHUNKS * 4), (void*)((int*)bv_start_addr+i*HV_CHUNKS * 4)); 
+    }
+    
+    // 3) Bundle all the level vectors together to obtain the HDC vector representation of the input feature vector
+    for (int i = 0; i < DS_FEATURE_SIZE; i++){
+        hvbundle((void*)((int*)spmaddrD), (void*)((int*)spmaddrD), (void*)((int*)spmaddrC + i * HV_CHUNKS * 4)) ;  
+    }
+
+    // 4) Clip the HDC vector
+    HV Clipped_HV;
+    hvclip((void*)((int*)spmaddrC), (void*)((int*)spmaddrD), (void*)(DS_FEATURE_SIZE));
+    // hvmemstr(&Clipped_HV.chunk[0], (void*)((int*)spmaddrC), sizeof(Clipped_HV));
+
+    int class_offset = HV_CHUNKS*4*2;
+    
+    for (int i = 0; i < HD_CV_LEN; i++){
+        hvsim((void*)((int*)spmaddrC+HV_CHUNKS * 4), (void*)((int*)spmaddrD + class_offset + i*HV_CHUNKS * 4), (void*)((int*)spmaddrC)) ;
+        hvmemstr(&hamming_distance, (void*)((int*)spmaddrC+HV_CHUNKS * 4), sizeof(int));
+        if (hamming_distance < minimum_distance)
+        {
+            minimum_distance = hamming_distance;
+            predicted_class = i;
+        }
+    }
+
+    int accl_cycle = finish_count();
+    printf("Accelerated Execution: %d cycles\n", accl_cycle);
+
+    return predicted_class;
+}
+
+// Anytime inference. Binding, bundling and clipping work element by element, so word w of the encoded HV
+// only needs word w of the item memories, and the Hamming distances are sums over the words: after m bits
+// the distances are partial sums of the full ones. The difference of the distances to two classes only
+// moves on the m bits where the classes differ, by +-1 each, so for a query that favours neither it has
+// standard deviation sqrt(m): a margin d between the two best classes is trusted when d^2 > confidence^2 m.
+// A margin larger than the bits still to score is final.
+int HDC_op::progressive_inference(int quantized_features[DS_FEATURE_SIZE], HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN], HV ClassVectors[HD_CV_LEN], float confidence, int& words)
+{
+    int distance[HD_CV_LEN];
+    for (int j = 0; j < HD_CV_LEN; j++)
+        distance[j] = 0;
+
+    const HV* Levels[DS_FEATURE_SIZE];
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        Levels[i] = &LevelVectors[quantized_features[i]];
+
+    int predicted_class = 0;
+    words = 0;
+    while (words < HV_CHUNKS) {
+        int last = words + (words == 0 ? PROGRESSIVE_FIRST : PROGRESSIVE_BLOCK);
+        if (last > HV_CHUNKS)
+            last = HV_CHUNKS;
+
+        for (int w = words; w < last; w++) {
+            // 1) Word w of the encoded HV
+            uint32_t encoded = encoded_word(Levels, BaseVectors, w);
+
+            // 2) Partial Hamming distances
+            for (int j = 0; j < HD_CV_LEN; j++)
+                distance[j] += __builtin_popcount(encoded ^ (uint32_t)ClassVectors[j].chunk[w]);
+        }
+        words = last;
+
+        // 3) Best and second best class
+        int best = HV_SIZE_BIT + 1, second = HV_SIZE_BIT + 1, second_class = 0;
+        for (int j = 0; j < HD_CV_LEN; j++) {
+            if (distance[j] < best) {
+                second = best;
+                second_class = predicted_class;
+                best = distance[j];
+                predicted_class = j;
+            } else if (distance[j] < second) {
+                second = distance[j];
+                second_class = j;
+            }
+        }
+
+        // 4) Confidence check on the margin
+        int margin = second - best;
+        if (margin > HV_SIZE_BIT - words * 32)
+            break;
+        int differing = 0;
+        for (int w = 0; w < words; w++)
+            differing += __builtin_popcount((uint32_t)(ClassVectors[predicted_class].chunk[w] ^ ClassVectors[second_class].chunk[w]));
+        if ((float)margin * margin > confidence * confidence * differing)
+            break;
+    }
     return predicted_class;
 }
 // --------------------End Inference----------------------
@@ -0,0 +1,138 @@
+#include "hdc_item_memory.hpp"
+
+// Streams of hv_hash used by the item memory, the base HVs use the feature index as stream
+#define LEVEL_STREAM       0x80000000u
+#define PERMUTATION_STREAM 0x80000001u
+#define HV_LEVEL_TAG       0x40000000
+
+// Constructor
+ProceduralItemMemory::ProceduralItemMemory(uint32_t seed, int levels) {
+    model_seed = seed;
+    num_levels = levels;
+    levels_flip = HV_SIZE_BIT / (2 * levels);
+
+    perm_bits = 1;
+    while ((1 << perm_bits) < HV_SIZE_BIT)
+        perm_bits++;
+    for (int round = 0; round < 3; round++)
+        perm_key[round] = hv_hash(model_seed, PERMUTATION_STREAM, round);
+
+    flush();
+}
+
+// Empty the cache
+void ProceduralItemMemory::flush() {
+    for (int i = 0; i < ITEM_CACHE_SIZE; i++) {
+        cache_tag[i] = -1;
+        cache_stamp[i] = 0;
+    }
+    clock = 0;
+    hits = 0;
+    misses = 0;
+}
+
+// Seeded bijection over [0, HV_SIZE_BIT).
+// Three keyed rounds of (odd multiply + add, xorshift) are a bijection over [0, 2^k) with 2^k >= HV_SIZE_BIT;
+// results out of range are walked through the same bijection again (cycle walking) until they fall in range.
+int ProceduralItemMemory::bit_permutation(int index) const {
+    uint32_t mask = (1u << perm_bits) - 1;
+
+    uint32_t x = (uint32_t)index;
+    do {
+        for (int round = 0; round < 3; round++) {
+            x = (x * (perm_key[round] | 1) + (perm_key[round] >> 16)) & mask;
+            x ^= x >> (perm_bits / 2 + 1);
+        }
+    } while (x >= HV_SIZE_BIT);
+
+    return (int)x;
+}
+
+// Base HV generation, bypassing the cache
+void ProceduralItemMemory::generate_base(int feature, HV& hv) const {
+    hv.randomize(model_seed, (uint32_t)feature);
+}
+
+// Level HV generation, bypassing the cache
+void ProceduralItemMemory::generate_level(int level, HV& hv) const {
+    hv.randomize(model_seed, LEVEL_STREAM);
+
+    // Flip the prefix of the permutation that belongs to the level: the prefixes are nested,
+    // so level l and level m differ in exactly |l - m| * levels_flip bits
+    for (int j = 0; j < level * levels_flip; j++) {
+        int index = bit_permutation(j);
+        hv.chunk[index / 32] ^= (1 << (index % 32));
+    }
+}
+
+// LRU lookup, regenerating the HV on a miss
+HV ProceduralItemMemory::lookup(int tag) {
+    clock++;
+    int victim = 0;
+    for (int i = 0; i < ITEM_CACHE_SIZE; i++) {
+        if (cache_tag[i] == tag) {
+            cache_stamp[i] = clock;
+            hits++;
+            return cache_hv[i];
+        }
+        if (cache_stamp[i] < cache_stamp[victim])
+            victim = i;
+    }
+
+    misses++;
+    if (tag & HV_LEVEL_TAG)
+        generate_level(tag & ~HV_LEVEL_TAG, cache_hv[victim]);
+    else
+        generate_base(tag, cache_hv[victim]);
+    cache_tag[victim] = tag;
+    cache_stamp[victim] = clock;
+    return cache_hv[victim];
+}
+
+// Base HV of a feature (cached)
+HV ProceduralItemMemory::base(int feature) {
+    return lookup(feature);
+}
+
+// Level HV (cached)
+HV ProceduralItemMemory::level(int level) {
+    return lookup(HV_LEVEL_TAG | level);
+}
+
+// Write all the base and level HVs, e.g. to load them in the SPMs
+void ProceduralItemMemory::materialize(HV BaseVectors[DS_FEATURE_SIZE], HV LevelVectors[HD_LV_LEN]) {
+    for (int i = 0; i < DS_FEATURE_SIZE; i++)
+        generate_base(i, BaseVectors[i]);
+    for (int l = 0; l < num_levels; l++)
+        generate_level(l, LevelVectors[l]);
+}
+
+// --------------------------- NodeMemory ---------------------------
+
+// Constructor
+NodeMemory::NodeMemory(uint32_t seed) {
+    model_seed = seed;
+    flush();
+}
+
+// Empty the cache
+void NodeMemory::flush() {
+    for (int i = 0; i < NODE_CACHE_SIZE; i++)
+        cache_tag[i] = -1;
+    hits = 0;
+    misses = 0;
+}
+
+// HV of a node (cached)
+HV NodeMemory::node(int node) {
+    int slot = node % NODE_CACHE_SIZE;
+    if (cache_tag[slot] == node) {
+        hits++;
+        return cache_hv[slot];
+    }
+
+    misses++;
+    cache_hv[slot].randomize(model_seed, (uint32_t)node);
+    cache_tag[slot] = node;
+    return cache_hv[slot];
+}
@@ -0,0 +1,157 @@
+#include <float.h>
+#include <string.h>
+#include "hdc_quantizer.hpp"
+
+// Clamp to [0, levels - 1]
+static inline int clamp_level(int level, int levels) {
+    level = level < 0 ? 0 : level;
+    return level > levels - 1 ? levels - 1 : level;
+}
+
+// --------------------------- UniformQuantizer ---------------------------
+
+// Constructor
+UniformQuantizer::UniformQuantizer(float min, float max, int levels) {
+    this->min = min;
+    this->max = max;
+    this->levels = levels;
+    scale = levels / (max - min);
+    offset = min * scale;
+    fixed_min = (int32_t)(min * (1 << QUANT_FRAC_BITS));
+    fixed_scale = (uint32_t)(scale * (float)(1 << (32 - QUANT_FRAC_BITS)));
+}
+
+// Level of a value: one multiply-subtract and a clamp
+int UniformQuantizer::quantize(float value) const {
+    float level = value * scale - offset;
+    level = level < 0 ? 0 : level;
+    level = level > levels - 1 ? levels - 1 : level;
+    return (int)level;
+}
+
+// Level of a fixed point value: the product with the reciprocal has the level in its upper 32 bits
+int UniformQuantizer::quantize(int32_t value) const {
+    int64_t level = (((int64_t)value - fixed_min) * fixed_scale) >> 32;
+    return clamp_level(level > levels ? levels : (int)level, levels);
+}
+
+// The loops have no data dependent branches, so the compiler can unroll and pipeline them
+void UniformQuantizer::quantize_batch(const float features[][DS_FEATURE_SIZE], int samples, uint8_t quantized[][DS_FEATURE_SIZE]) const {
+    for (int s = 0; s < samples; s++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            quantized[s][f] = (uint8_t)quantize(features[s][f]);
+}
+
+void UniformQuantizer::quantize_batch(const int32_t features[][DS_FEATURE_SIZE], int samples, uint8_t quantized[][DS_FEATURE_SIZE]) const {
+    for (int s = 0; s < samples; s++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            quantized[s][f] = (uint8_t)quantize(features[s][f]);
+}
+
+// --------------------------- QuantileSketch ---------------------------
+
+// Default constructor: empty sketch
+QuantileSketch::QuantileSketch() {
+    for (int i = 0; i < SKETCH_BUCKETS; i++) {
+        positive[i] = 0;
+        negative[i] = 0;
+    }
+    zero = 0;
+    count = 0;
+}
+
+// Bucket of a magnitude: exponent and first mantissa bits of the float, clamped to the covered range
+static inline int sketch_bucket(float magnitude) {
+    uint32_t bits;
+    memcpy(&bits, &magnitude, sizeof(bits));
+    int exponent = (int)((bits >> 23) & 0xFF) - 127 + SKETCH_BINADES / 2;
+    int bucket = exponent * SKETCH_SUBBUCKETS + (int)((bits & 0x7FFFFF) / (0x800000 / SKETCH_SUBBUCKETS));
+    bucket = bucket < 0 ? 0 : bucket;
+    return bucket > SKETCH_BUCKETS - 1 ? SKETCH_BUCKETS - 1 : bucket;
+}
+
+// Middle of the magnitudes of a bucket
+static inline float sketch_value(int bucket) {
+    uint32_t exponent = bucket / SKETCH_SUBBUCKETS - SKETCH_BINADES / 2 + 127;
+    uint32_t mantissa = (2 * (bucket % SKETCH_SUBBUCKETS) + 1) * (0x800000 / (2 * SKETCH_SUBBUCKETS));
+    uint32_t bits = (exponent << 23) | mantissa;
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Add a value
+void QuantileSketch::add(float value) {
+    if (value > 0)
+        positive[sketch_bucket(value)]++;
+    else if (value < 0)
+        negative[sketch_bucket(-value)]++;
+    else
+        zero++;
+    count++;
+}
+
+// Add the counts of another sketch
+void QuantileSketch::merge(const QuantileSketch& other) {
+    for (int i = 0; i < SKETCH_BUCKETS; i++) {
+        positive[i] += other.positive[i];
+        negative[i] += other.negative[i];
+    }
+    zero += other.zero;
+    count += other.count;
+}
+
+// Walk the buckets in increasing order of value: negative from the largest magnitude, zero, positive
+float QuantileSketch::quantile(float q) const {
+    int rank = (int)(q * count);
+    rank = rank > count - 1 ? count - 1 : rank;
+    int seen = 0;
+    for (int i = SKETCH_BUCKETS - 1; i >= 0; i--) {
+        seen += negative[i];
+        if (seen > rank)
+            return -sketch_value(i);
+    }
+    seen += zero;
+    if (seen > rank)
+        return 0;
+    for (int i = 0; i < SKETCH_BUCKETS; i++) {
+        seen += positive[i];
+        if (seen > rank)
+            return sketch_value(i);
+    }
+    return 0;
+}
+
+// --------------------------- QuantileQuantizer ---------------------------
+
+// Constructor: all the values in level 0 until fit is called
+QuantileQuantizer::QuantileQuantizer(int levels) {
+    this->levels = levels;
+    for (int f = 0; f < DS_FEATURE_SIZE; f++)
+        for (int l = 0; l < QUANT_TABLE_SIZE; l++)
+            thresholds[f][l] = FLT_MAX;
+}
+
+// Thresholds from the sketches of the features
+void QuantileQuantizer::fit(const QuantileSketch sketches[DS_FEATURE_SIZE]) {
+    for (int f = 0; f < DS_FEATURE_SIZE; f++)
+        for (int l = 0; l < levels - 1; l++)
+            thresholds[f][l] = sketches[f].quantile((float)(l + 1) / levels);
+}
+
+// Number of thresholds lower or equal to the value: each step halves the window and moves its
+// base with a comparison result instead of a branch. Only an infinite value can pass the padding.
+int QuantileQuantizer::quantize(int feature, float value) const {
+    const float* table = thresholds[feature];
+    int level = 0;
+    for (int step = QUANT_TABLE_SIZE / 2; step > 0; step /= 2)
+        level += (table[level + step - 1] <= value) * step;
+    return level > levels - 1 ? levels - 1 : level;
+}
+
+// Levels of a whole feature matrix, one uint8 per feature
+void QuantileQuantizer::quantize_batch(const float features[][DS_FEATURE_SIZE], int samples, uint8_t quantized[][DS_FEATURE_SIZE]) const {
+    for (int s = 0; s < samples; s++)
+        for (int f = 0; f < DS_FEATURE_SIZE; f++)
+            quantized[s][f] = (uint8_t)quantize(f, features[s][f]);
+}
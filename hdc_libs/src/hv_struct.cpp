@@ -1,5 +1,98 @@
 #include "hv_struct.hpp"
 
+// Final mixer of MurmurHash3: full avalanche of the 32 input bits
+static inline uint32_t hv_mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// Counter-based generator: two mixing rounds over (seed, stream) and then the counter
+uint32_t hv_hash(uint32_t seed, uint32_t stream, uint32_t counter) {
+    uint32_t key = hv_mix(seed ^ (0x9E3779B9u * (stream + 1)));
+    return hv_mix(key ^ (0x27D4EB2Fu + counter * 0x165667B1u));
+}
+
+static inline uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// Default constructor: fixed seed
+HVRng::HVRng() {
+    seed(0x2545F491u);
+}
+
+// Seeded constructor
+HVRng::HVRng(uint32_t seed_value) {
+    seed(seed_value);
+}
+
+// Re-seed the generator, the state is expanded from the seed with the counter-based hash
+void HVRng::seed(uint32_t seed_value) {
+    for (int i = 0; i < 4; i++)
+        s[i] = hv_hash(seed_value, 0xFFFFFFFFu, i);
+    if ((s[0] | s[1] | s[2] | s[3]) == 0)
+        s[0] = 1;
+}
+
+// Next 32 random bits
+uint32_t HVRng::next() {
+    uint32_t result = rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+}
+
+// Uniform integer in [0, n): multiply-shift instead of the modulo
+uint32_t HVRng::bounded(uint32_t n) {
+    return (uint32_t)(((uint64_t)next() * n) >> 32);
+}
+
+// Fill n words with random bits, the state is kept in registers for the whole loop
+void HVRng::fill(int* dst, int n) {
+    uint32_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+    for (int i = 0; i < n; i++) {
+        dst[i] = (int)(rotl(s1 * 5, 7) * 9);
+        uint32_t t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 11);
+    }
+    s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+}
+
+// Advance by 2^64 draws
+void HVRng::jump() {
+    static const uint32_t JUMP[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    uint32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 32; b++) {
+            if (JUMP[i] & (1u << b)) {
+                s0 ^= s[0];
+                s1 ^= s[1];
+                s2 ^= s[2];
+                s3 ^= s[3];
+            }
+            next();
+        }
+    }
+    s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+}
+
+// Generator used by the deprecated HV::randomize() without arguments, shared by all the callers
+static HVRng default_rng;
+
 // Default constructor: Initializes all data elements to zero
 HV::HV() {
     for (int i = 0; i < HV_CHUNKS; ++i) {
@@ -26,9 +119,18 @@ HV& HV::operator=(const HV& other) {
 
 // Define the randomize function
 void HV::randomize() {
+    default_rng.fill(chunk, HV_CHUNKS);
+}
+
+// Randomize with a given generator
+void HV::randomize(HVRng& rng) {
+    rng.fill(chunk, HV_CHUNKS);
+}
+
+// Deterministic randomization: word i is hv_hash(seed, stream, i)
+void HV::randomize(uint32_t seed, uint32_t stream) {
     for (int i = 0; i < HV_CHUNKS; ++i) {
-        int random_number = rand();
-        chunk[i] = random_number;
+        chunk[i] = (int)hv_hash(seed, stream, i);
     }
 }
 
@@ -90,6 +192,22 @@ BundledHV& BundledHV::operator=(const HV& other) {
     return *this;
 }
 
+// Counter of the element at bit position 'bit' (0 = LSB) of HV chunk 'chunk'.
+// Each HV chunk is spread over 4 bundled chunks, the most significant byte first,
+// with the counters of a byte stored from bit 28 (MSB of the byte) down to bit 0.
+int BundledHV::get_counter(int chunk, int bit) const {
+    int index = chunk * COUNTER_BITS + (31 - bit) / 8;
+    int shift = 28 - COUNTER_BITS * ((31 - bit) % 8);
+    return (bundled_chunk[index] >> shift) & 0xF;
+}
+
+// Overwrite the counter of the element at bit position 'bit' of HV chunk 'chunk'
+void BundledHV::set_counter(int chunk, int bit, int value) {
+    int index = chunk * COUNTER_BITS + (31 - bit) / 8;
+    int shift = 28 - COUNTER_BITS * ((31 - bit) % 8);
+    bundled_chunk[index] = (bundled_chunk[index] & ~(0xF << shift)) | ((value & 0xF) << shift);
+}
+
 // Print Operator, bit by bit
 void BundledHV::print() {
     printf("[");
@@ -100,3 +218,177 @@ void BundledHV::print() {
     }
     printf("]\n");
 }
+
+// --------------------------- SlicedHV ---------------------------
+
+SlicedHV::SlicedHV() {
+    for (int p = 0; p < SLICED_PLANES; ++p)
+        for (int i = 0; i < HV_CHUNKS; ++i)
+            plane[p][i] = 0;
+    count = 0;
+}
+
+void SlicedHV::add(const HV& hv) {
+    for (int i = 0; i < HV_CHUNKS; ++i)
+        add_chunk(i, hv.chunk[i]);
+    count++;
+}
+
+// Half adders from the least significant plane, until no element carries
+void SlicedHV::add_chunk(int chunk, uint32_t bits) {
+    uint32_t carry = bits;
+    for (int p = 0; p < SLICED_PLANES && carry != 0; ++p) {
+        uint32_t sum = plane[p][chunk] ^ carry;
+        carry &= plane[p][chunk];
+        plane[p][chunk] = sum;
+    }
+}
+
+int SlicedHV::get_counter(int chunk, int bit) const {
+    int counter = 0;
+    for (int p = 0; p < SLICED_PLANES; ++p)
+        counter |= ((plane[p][chunk] >> bit) & 1) << p;
+    return counter;
+}
+
+// Comparison from the most significant plane: an element is greater as soon as it has a 1
+// where the threshold has a 0 and all the more significant planes are equal
+HV SlicedHV::threshold(int threshold) const {
+    HV result;
+    for (int i = 0; i < HV_CHUNKS; ++i) {
+        uint32_t greater = 0;
+        uint32_t equal = 0xFFFFFFFF;
+        for (int p = SLICED_PLANES - 1; p >= 0; --p) {
+            uint32_t bits = plane[p][i];
+            if ((threshold >> p) & 1) {
+                equal &= bits;
+            } else {
+                greater |= equal & bits;
+                equal &= ~bits;
+            }
+        }
+        result.chunk[i] = greater;
+    }
+    return result;
+}
+
+// --------------------------- SparseHV ---------------------------
+
+SparseHV::SparseHV() {
+    ones = 0;
+}
+
+// Floyd's sampling of distinct positions, then an insertion sort (the lists are short)
+void SparseHV::randomize(HVRng& rng, int ones) {
+    this->ones = (uint16_t)(ones > SPARSE_MAX_ONES ? SPARSE_MAX_ONES : ones);
+    for (int n = 0; n < this->ones; ++n) {
+        int candidate = rng.bounded(HV_SIZE_BIT - this->ones + n + 1);
+        for (int i = 0; i < n; ++i) {
+            if (index[i] == candidate) {
+                candidate = HV_SIZE_BIT - this->ones + n;
+                break;
+            }
+        }
+        int i = n;
+        for (; i > 0 && index[i - 1] > candidate; --i)
+            index[i] = index[i - 1];
+        index[i] = (uint16_t)candidate;
+    }
+}
+
+HV SparseHV::to_dense() const {
+    HV hv;
+    for (int i = 0; i < ones; ++i)
+        hv.chunk[index[i] / 32] |= (1u << (index[i] % 32));
+    return hv;
+}
+
+void SparseHV::from_dense(const HV& hv) {
+    ones = 0;
+    for (int c = 0; c < HV_CHUNKS && ones < SPARSE_MAX_ONES; ++c) {
+        uint32_t bits = hv.chunk[c];
+        while (bits != 0 && ones < SPARSE_MAX_ONES) {
+            index[ones++] = (uint16_t)(c * 32 + __builtin_ctz(bits));
+            bits &= bits - 1;
+        }
+    }
+}
+
+// Print Operator, positions of the ones
+void SparseHV::print() {
+    printf("[");
+    for (int i = 0; i < ones; ++i)
+        printf(i ? " %d" : "%d", index[i]);
+    printf("]\n");
+}
+
+// --------------------------- BlockHV ---------------------------
+
+BlockHV::BlockHV() {
+    for (int i = 0; i < BLOCK_WORDS; ++i)
+        word[i] = 0;
+}
+
+int BlockHV::get(int block) const {
+    return (word[block / 4] >> (8 * (block % 4))) & 0xFF;
+}
+
+void BlockHV::set(int block, int position) {
+    int shift = 8 * (block % 4);
+    word[block / 4] = (word[block / 4] & ~(0xFFu << shift)) | ((uint32_t)position << shift);
+}
+
+void BlockHV::randomize(HVRng& rng) {
+    for (int b = 0; b < BLOCK_COUNT; ++b)
+        set(b, rng.bounded(BLOCK_LEN));
+}
+
+HV BlockHV::to_dense() const {
+    HV hv;
+    for (int b = 0; b < BLOCK_COUNT; ++b) {
+        int bit = b * BLOCK_LEN + get(b);
+        hv.chunk[bit / 32] |= (1u << (bit % 32));
+    }
+    return hv;
+}
+
+// Print Operator, active position of each block
+void BlockHV::print() {
+    printf("[");
+    for (int b = 0; b < BLOCK_COUNT; ++b)
+        printf(b ? " %d" : "%d", get(b));
+    printf("]\n");
+}
+
+// --------------------------- BipolarHV ---------------------------
+
+BipolarHV::BipolarHV() {
+    for (int d = 0; d < HV_SIZE_BIT; ++d)
+        element[d] = 0;
+}
+
+void BipolarHV::from_binary(const HV& hv, int value) {
+    for (int d = 0; d < HV_SIZE_BIT; ++d)
+        element[d] = (int8_t)(((hv.chunk[d / 32] >> (d % 32)) & 1) ? -value : value);
+}
+
+HV BipolarHV::to_binary() const {
+    HV hv;
+    for (int d = 0; d < HV_SIZE_BIT; ++d)
+        if (element[d] < 0)
+            hv.chunk[d / 32] |= (1u << (d % 32));
+    return hv;
+}
+
+// Print Operator, element by element
+void BipolarHV::print() {
+    printf("[");
+    for (int d = 0; d < HV_SIZE_BIT; ++d)
+        printf(d ? " %d" : "%d", element[d]);
+    printf("]\n");
+}
+
+BundledBipolarHV::BundledBipolarHV() {
+    for (int d = 0; d < HV_SIZE_BIT; ++d)
+        element[d] = 0;
+}
@@ -23,6 +23,7 @@ int main() {
         printf("*********************************************\e[39m\n\n");
 
         
+        test_random_generation();
         clean_SPMs();
         test_binding();
         clean_SPMs();
@@ -36,9 +37,55 @@ int main() {
         clean_SPMs();
         test_search();   
         clean_SPMs();
+        test_level_vectors();
+        clean_SPMs();
         test_encoding();
-        // clean_SPMs();
-        // test_temporal_encoding();
+        clean_SPMs();
+        test_incremental_encoding();
+        clean_SPMs();
+        test_table_encoding();
+        clean_SPMs();
+        test_positional_encoding();
+        clean_SPMs();
+        test_procedural_item_memory();
+        clean_SPMs();
+        test_projection_encoding();
+        clean_SPMs();
+        test_text_encoding();
+        clean_SPMs();
+        test_image_encoding();
+        clean_SPMs();
+        test_graph_encoding();
+        clean_SPMs();
+        test_record_memory();
+        clean_SPMs();
+        test_resonator();
+        clean_SPMs();
+        test_quantization();
+        clean_SPMs();
+        test_quantile_quantization();
+        clean_SPMs();
+        test_sparse_hv();
+        clean_SPMs();
+        test_block_hv();
+        clean_SPMs();
+        test_bipolar_hv();
+        clean_SPMs();
+        test_cosine_search();
+        clean_SPMs();
+        test_mixed_precision();
+        clean_SPMs();
+        test_compact_model();
+        clean_SPMs();
+        test_progressive_inference();
+        clean_SPMs();
+        test_hierarchical_memory();
+        clean_SPMs();
+        test_ensemble();
+        clean_SPMs();
+        test_regression();
+        clean_SPMs();
+        test_temporal_encoding();
         clean_SPMs();
         test_training();
         clean_SPMs();